@@ -0,0 +1,325 @@
+/**
+ * @file sudoku-bench.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Solver and generator throughput benchmarks.
+ * @date 2024-09-20
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <board.h>
+#include <solver.h>
+#include <dlx-solver.h>
+#include <generator.h>
+#include <grader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "version.h"
+
+/**
+ * @brief Heap allocations done by the process.
+ * 
+ */
+static std::atomic<unsigned long> allocations{};
+
+void *operator new(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (auto p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+/**
+ * @brief 17 clue boards (minimum clue count for an unique solution).
+ * 
+ */
+static const char *corpus_17[] = {
+	"000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+	"000000010400000000020000000000050604008000300001090000300400200050100000000807000",
+	"000000012000035000000600070700000300000400800100000000000120000080000040050000600",
+	"000000012003600000000007000410020000000500300700000600280000040000300500000000000",
+	"000000012008030000000000040120500000000004700060000000507000300000620000000100000",
+	"000000012040050000000009000070600400000100000000000050000087500601000300200000000",
+	"000000012050400000000000030700600400001000000000080000920000800000510700000003000",
+	"000000012300000060000040000900000500000001070020000000000350400001400800060000000",
+	"000000012400090000000000050070200000600000400000108000018000000000030700502000000",
+	"000000012500008000000700000600120000700000450000030000030000800000500700020000000",
+};
+
+/**
+ * @brief Benchmark settings.
+ * 
+ */
+struct Options {
+	unsigned seed{20240920}; /** Generator seed. */
+	unsigned iterations{}; /** Operations per workload (0: workload default). */
+	std::string hardest{SUDOKU_SOURCE_DIR "/hardest.xml"}; /** hardest.xml path. */
+	std::string output; /** JSON output file (empty: stdout). */
+	std::string filter; /** Run only workloads containing this text. */
+};
+
+/**
+ * @brief Measures of one workload.
+ * 
+ */
+struct Result {
+	std::string name; /** Workload name. */
+	std::vector<double> samples; /** Latency of each operation (us). */
+	unsigned long allocations{}; /** Heap allocations of all the operations. */
+};
+
+/**
+ * @brief Builds a board from a line, one char per cell (0 for empty cell).
+ */
+static Board from_line(const std::string line) {
+	Board board(line.size());
+	auto w = board.get_width();
+	for (unsigned i = 0; i < line.size(); i ++) {
+		unsigned v = line[i] - '0';
+		board.set(i % w, i / w, {v, v != 0});
+	}
+	return board;
+}
+
+/**
+ * @brief Runs op the given times and records its latency and allocations.
+ * 
+ * @param name workload name.
+ * @param iterations number of operations.
+ * @param op operation, receives the operation index.
+ */
+static Result run(const std::string name, const unsigned iterations,
+		const std::function<void(const unsigned)> &op) {
+	Result result;
+	result.name = name;
+	result.samples.reserve(iterations);
+
+	auto allocs = allocations.load();
+	for (unsigned i = 0; i < iterations; i ++) {
+		auto start = std::chrono::steady_clock::now();
+		op(i);
+		auto end = std::chrono::steady_clock::now();
+		result.samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+	}
+	// The samples vector was reserved: only the operations allocate.
+	result.allocations = allocations.load() - allocs;
+
+	std::cerr << name << ": " << iterations << " ops." << std::endl;
+
+	return result;
+}
+
+/**
+ * @brief Returns the p-th percentile of the samples (sorted).
+ */
+static double percentile(const std::vector<double> &sorted, const double p) {
+	if (sorted.empty()) return 0;
+	auto index = unsigned(p * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+/**
+ * @brief Writes the results as JSON.
+ */
+static void write_json(std::ostream &out, const Options &options, std::vector<Result> &results) {
+	out << "{\n";
+	out << "\t\"version\": \"" << SUDOKU_VERSION << "\",\n";
+	out << "\t\"build_type\": \"" << SUDOKU_BUILD_TYPE << "\",\n";
+	out << "\t\"seed\": " << options.seed << ",\n";
+	out << "\t\"benchmarks\": [";
+
+	for (unsigned r = 0; r < results.size(); r ++) {
+		auto &result = results[r];
+		auto sorted = result.samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		double total = 0;
+		for (auto s : sorted) total += s;
+		auto ops = sorted.size();
+
+		out << (r ? ",\n" : "\n");
+		out << "\t\t{\"name\": \"" << result.name << "\", ";
+		out << "\"ops\": " << ops << ", ";
+		out << "\"ops_per_sec\": " << (total > 0 ? ops * 1e6 / total : 0) << ", ";
+		out << "\"mean_us\": " << (ops ? total / ops : 0) << ", ";
+		out << "\"p50_us\": " << percentile(sorted, 0.50) << ", ";
+		out << "\"p99_us\": " << percentile(sorted, 0.99) << ", ";
+		out << "\"allocs_per_op\": " << (ops ? double(result.allocations) / ops : 0) << "}";
+	}
+
+	out << "\n\t]\n}\n";
+}
+
+/**
+ * @brief Parses the command line.
+ * 
+ * @return false on invalid arguments.
+ */
+static const bool parse(int argc, char *argv[], Options &options) {
+	for (int i = 1; i < argc; i ++) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) return false;
+
+		if (arg == "--seed") options.seed = std::atoi(argv[++ i]);
+		else if (arg == "--iterations") options.iterations = std::atoi(argv[++ i]);
+		else if (arg == "--hardest") options.hardest = argv[++ i];
+		else if (arg == "--output") options.output = argv[++ i];
+		else if (arg == "--filter") options.filter = argv[++ i];
+		else return false;
+	}
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	Options options;
+	if (!parse(argc, argv, options)) {
+		std::cerr << "Usage: sudoku-bench [--seed N] [--iterations N] [--hardest PATH]"
+				" [--output FILE] [--filter TEXT]" << std::endl;
+		return 2;
+	}
+
+	// The engine log would be measured with the operations: drop it.
+	std::ostream out(std::cout.rdbuf());
+	std::cout.rdbuf(nullptr);
+
+	std::vector<Result> results;
+	auto iterations = [&options](const unsigned def) {
+		return options.iterations ? options.iterations : def;
+	};
+	auto enabled = [&options](const std::string name) {
+		return name.find(options.filter) != std::string::npos;
+	};
+
+	// Solving workloads
+	Board hardest;
+	if (!hardest.load(options.hardest)) return 1;
+
+	std::vector<Board> corpus;
+	for (auto line : corpus_17) corpus.push_back(from_line(line));
+
+	// Boards with many solutions: a 17 clue board without its first clue.
+	std::vector<Board> sparse;
+	for (auto board : corpus) {
+		for (unsigned i = 0; i < board.get_size(); i ++) {
+			auto w = board.get_width();
+			if (!board.get(i % w, i / w).value) continue;
+			board.set(i % w, i / w, {0, false});
+			break;
+		}
+		sparse.push_back(board);
+	}
+
+	SolverOptions row_major;
+	row_major.branching = SolverOptions::Branching::ROW_MAJOR;
+	SolverOptions no_propagation;
+	no_propagation.propagation = false;
+
+	if (enabled("solve/hardest"))
+		results.push_back(run("solve/hardest", iterations(200), [&](const unsigned) {
+			Solver::solve(hardest, 1);
+		}));
+	if (enabled("solve/hardest-row-major"))
+		results.push_back(run("solve/hardest-row-major", iterations(20), [&](const unsigned) {
+			Solver::solve(hardest, 1, row_major);
+		}));
+	if (enabled("solve/hardest-no-propagation"))
+		results.push_back(run("solve/hardest-no-propagation", iterations(200), [&](const unsigned) {
+			Solver::solve(hardest, 1, no_propagation);
+		}));
+	if (enabled("solve/hardest-dlx"))
+		results.push_back(run("solve/hardest-dlx", iterations(200), [&](const unsigned) {
+			DlxSolver::solve(hardest, 1);
+		}));
+	if (enabled("solve/17-clue"))
+		results.push_back(run("solve/17-clue", iterations(200), [&](const unsigned i) {
+			Solver::solve(corpus[i % corpus.size()], 1);
+		}));
+	if (enabled("solve/17-clue-no-propagation"))
+		results.push_back(run("solve/17-clue-no-propagation", iterations(200), [&](const unsigned i) {
+			Solver::solve(corpus[i % corpus.size()], 1, no_propagation);
+		}));
+	if (enabled("solve/17-clue-dlx"))
+		results.push_back(run("solve/17-clue-dlx", iterations(200), [&](const unsigned i) {
+			DlxSolver::solve(corpus[i % corpus.size()], 1);
+		}));
+	if (enabled("unique/17-clue"))
+		results.push_back(run("unique/17-clue", iterations(200), [&](const unsigned i) {
+			Solver::has_unique_solution(corpus[i % corpus.size()]);
+		}));
+	if (enabled("grade/17-clue"))
+		results.push_back(run("grade/17-clue", iterations(200), [&](const unsigned i) {
+			Grader::grade(corpus[i % corpus.size()]);
+		}));
+	if (enabled("count/100"))
+		results.push_back(run("count/100", iterations(100), [&](const unsigned i) {
+			Solver::count_solutions(sparse[i % sparse.size()], 100);
+		}));
+	if (enabled("count/100-dlx"))
+		results.push_back(run("count/100-dlx", iterations(100), [&](const unsigned i) {
+			DlxSolver::count(sparse[i % sparse.size()], 100);
+		}));
+
+	// Generation workloads, seeded for reproducible boards
+	for (unsigned size : {81u, 16u, 256u}) {
+		for (unsigned difficulty = 0; difficulty < 3; difficulty ++) {
+			auto name = "generate/" + std::to_string(size) + "-" +
+					Generator::difficulty_name(difficulty);
+			if (!enabled(name)) continue;
+
+			Generator::seed(options.seed);
+			// A 16x16 board takes up to a second or two.
+			results.push_back(run(name, iterations(size > 81 ? 5 : 50), [&](const unsigned) {
+				Generator::generate_graded(size, difficulty);
+			}));
+		}
+	}
+
+	// Persistence workload
+	if (enabled("board/save-load")) {
+		char path[] = "/tmp/sudoku-bench-XXXXXX";
+		auto fd = mkstemp(path);
+		if (fd >= 0) close(fd);
+		results.push_back(run("board/save-load", iterations(200), [&](const unsigned i) {
+			auto board = corpus[i % corpus.size()];
+			board.save(path);
+			board.load(path);
+		}));
+		std::remove(path);
+	}
+
+	if (enabled("board/save-load-binary")) {
+		char path[] = "/tmp/sudoku-bench-XXXXXX";
+		auto fd = mkstemp(path);
+		if (fd >= 0) close(fd);
+		results.push_back(run("board/save-load-binary", iterations(200), [&](const unsigned i) {
+			auto board = corpus[i % corpus.size()];
+			board.save(path, Board::Format::BINARY);
+			board.load(path);
+		}));
+		std::remove(path);
+	}
+
+	if (options.output.empty()) write_json(out, options, results);
+	else {
+		std::ofstream file(options.output);
+		write_json(file, options, results);
+	}
+
+	return 0;
+}
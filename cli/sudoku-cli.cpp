@@ -0,0 +1,303 @@
+/**
+ * @file sudoku-cli.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Headless command line frontend: batch generation and solving.
+ * @date 2024-09-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <board.h>
+#include <solver.h>
+#include <dlx-solver.h>
+#include <generator.h>
+#include <generator-pool.h>
+#include <grader.h>
+
+#include <chrono>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "version.h"
+
+/**
+ * @brief Command line settings.
+ * 
+ */
+struct Options {
+	std::string command; /** generate, solve or grade. */
+	unsigned count{1}; /** Boards to generate. */
+	unsigned size{81}; /** Board size. */
+	unsigned difficulty{}; /** 0: Easy, 1: Medium, 2: Hard. */
+	unsigned workers{}; /** Generator threads (0: auto). */
+	unsigned max_solutions{1}; /** Solutions to look for. */
+	bool dlx{}; /** Use the exact cover solver. */
+	bool quiet{}; /** No engine log. */
+	std::vector<std::string> files; /** Input files ("-" for stdin). */
+};
+
+/**
+ * @brief Milliseconds elapsed since the given time point.
+ */
+static double elapsed_ms(const std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Writes the board values in a single line, one char per cell
+ * (0 for empty cell, A to P for 10 to 25).
+ */
+static std::string to_line(const Board &board) {
+	std::string line;
+	auto w = board.get_width();
+	for (unsigned i = 0; i < board.get_size(); i ++)
+		line += Board::symbol(board.get(i % w, i / w).value);
+	return line;
+}
+
+/**
+ * @brief Reads a board from a single line, one char per cell
+ * ('0' or '.' for empty cell, A to P for 10 to 25). Blanks are ignored.
+ * 
+ * @return false if the line is not a 4x4, 6x6, 9x9, 16x16 or 25x25 board.
+ */
+static const bool from_line(const std::string line, Board &board) {
+	std::vector<unsigned> values;
+	for (auto c : line) {
+		if (std::isspace(c)) continue;
+		if (c == '.') values.push_back(0);
+		else if (std::isalnum((unsigned char)c)) values.push_back(Board::symbol_value(c));
+		else return false;
+	}
+
+	if (!Board::is_supported_size(values.size())) return false;
+
+	board = Board(values.size());
+	auto w = board.get_width();
+	for (unsigned i = 0; i < values.size(); i ++) {
+		if (values[i] > w) return false;
+		board.set(i % w, i / w, {values[i], values[i] != 0});
+	}
+
+	return true;
+}
+
+/**
+ * @brief Prints the command line help.
+ */
+static void usage() {
+	std::cerr <<
+		"Sudoku " SUDOKU_VERSION " command line.\n"
+		"\n"
+		"Usage:\n"
+		"  sudoku-cli generate [-n COUNT] [-s 16|36|81|256|625] [-d easy|medium|hard] [-j WORKERS] [-q]\n"
+		"  sudoku-cli solve [-m MAX] [--dlx] [-q] [FILE ...]\n"
+		"  sudoku-cli grade [-q] [FILE ...]\n"
+		"\n"
+		"generate  Prints COUNT new boards, one per line (0 for empty cells).\n"
+		"solve     Solves the boards of the files (board xml files or one board\n"
+		"          per line), or of the standard input when no file or \"-\" is given.\n"
+		"          Prints the first solution and the solution count (up to MAX).\n"
+		"grade     Rates the boards of the files like solve. Prints the difficulty,\n"
+		"          the rating, the hardest technique and the number of steps.\n"
+		"\n"
+		"Timings are reported on the standard error.\n";
+}
+
+/**
+ * @brief Parses the command line.
+ * 
+ * @return false on invalid arguments.
+ */
+static const bool parse(int argc, char *argv[], Options &options) {
+	if (argc < 2) return false;
+	options.command = argv[1];
+
+	for (int i = 2; i < argc; i ++) {
+		std::string arg = argv[i];
+		auto value = [&]() -> std::string { return i + 1 < argc ? argv[++ i] : ""; };
+
+		if (arg == "-n") options.count = std::atoi(value().c_str());
+		else if (arg == "-s") options.size = std::atoi(value().c_str());
+		else if (arg == "-j") options.workers = std::atoi(value().c_str());
+		else if (arg == "-m") options.max_solutions = std::atoi(value().c_str());
+		else if (arg == "-d") {
+			auto d = value();
+			if (d == "easy") options.difficulty = 0;
+			else if (d == "medium") options.difficulty = 1;
+			else if (d == "hard") options.difficulty = 2;
+			else return false;
+		}
+		else if (arg == "--dlx") options.dlx = true;
+		else if (arg == "-q") options.quiet = true;
+		else if (arg == "-h" || arg == "--help") return false;
+		else if (arg[0] == '-' && arg != "-") return false;
+		else options.files.push_back(arg);
+	}
+
+	if (!Board::is_supported_size(options.size)) return false;
+	if (options.max_solutions == 0) options.max_solutions = 1;
+
+	return options.command == "generate" || options.command == "solve" ||
+			options.command == "grade";
+}
+
+/**
+ * @brief Generates the requested boards on the worker pool.
+ */
+static int generate(const Options &options, std::ostream &out) {
+	GeneratorPool pool(options.workers);
+
+	auto start = std::chrono::steady_clock::now();
+
+	// One racer per board: the workers build different boards in parallel.
+	std::list<std::future<GeneratedBoard>> boards;
+	for (unsigned i = 0; i < options.count; i ++)
+		boards.push_back(pool.generate(options.size, options.difficulty, nullptr, 1));
+
+	unsigned generated = 0;
+	for (auto &future : boards) {
+		auto board = future.get().board;
+		if (board.empty()) continue;
+		out << to_line(board) << std::endl;
+		generated ++;
+	}
+
+	auto ms = elapsed_ms(start);
+	std::cerr << "Generated " << generated << " " << Generator::difficulty_name(options.difficulty) <<
+		" board(s) of size " << options.size << " with " << pool.get_workers() << " worker(s) in " <<
+		ms << " ms (" << (ms > 0 ? generated * 1000.0 / ms : 0) << " boards/s)." << std::endl;
+
+	return generated == options.count ? 0 : 1;
+}
+
+/**
+ * @brief Rates one board and prints the result line.
+ * 
+ * @return false if the board needs guessing.
+ */
+static const bool grade_board(const Board &board, std::ostream &out, double &total_ms) {
+	auto start = std::chrono::steady_clock::now();
+	auto grade = Grader::grade(board);
+	auto ms = elapsed_ms(start);
+	total_ms += ms;
+
+	out << Generator::difficulty_name(Grader::difficulty(grade)) << " " << grade.rating << " " <<
+		Grader::technique_name(grade.hardest) << " " << grade.steps << " " << ms << std::endl;
+
+	return grade.is_solved();
+}
+
+/**
+ * @brief Solves one board and prints the result line.
+ * 
+ * @return false if the board has no solution.
+ */
+static const bool solve_board(const Board &board, const Options &options,
+		std::ostream &out, double &total_ms) {
+	if (options.command == "grade") return grade_board(board, out, total_ms);
+
+	auto start = std::chrono::steady_clock::now();
+	auto solutions = options.dlx ? DlxSolver::solve(board, options.max_solutions) :
+			Solver::solve(board, options.max_solutions);
+	auto ms = elapsed_ms(start);
+	total_ms += ms;
+
+	if (solutions.empty()) out << "no solution";
+	else out << to_line(solutions.front());
+	out << " " << solutions.size() << " " << ms << std::endl;
+
+	return !solutions.empty();
+}
+
+/**
+ * @brief Solves every board of a stream with one board per line.
+ */
+static void solve_stream(std::istream &in, const Options &options, std::ostream &out,
+		unsigned &solved, unsigned &total, double &total_ms) {
+	std::string line;
+	while (std::getline(in, line)) {
+		if (line.empty() || line[0] == '#') continue;
+
+		Board board;
+		if (!from_line(line, board)) {
+			std::cerr << "Skipping invalid board: " << line << std::endl;
+			continue;
+		}
+
+		total ++;
+		if (solve_board(board, options, out, total_ms)) solved ++;
+	}
+}
+
+/**
+ * @brief Solves the boards of the given files or the standard input.
+ */
+static int solve(const Options &options, std::ostream &out) {
+	unsigned solved = 0, total = 0;
+	double total_ms = 0;
+
+	auto files = options.files;
+	if (files.empty()) files.push_back("-");
+
+	for (auto &file : files) {
+		if (file == "-") {
+			solve_stream(std::cin, options, out, solved, total, total_ms);
+			continue;
+		}
+
+		std::ifstream in(file);
+		if (!in) {
+			std::cerr << "Cannot open file: " << file << std::endl;
+			continue;
+		}
+
+		// Board file (xml or binary) or one board per line
+		std::string magic(std::char_traits<char>::length(Board::BINARY_MAGIC), '\0');
+		in.read(&magic[0], magic.size());
+		in.clear();
+		in.seekg(0);
+
+		char first = ' ';
+		while (in.get(first) && std::isspace(first));
+		in.clear();
+		in.seekg(0);
+
+		if (first == '<' || magic == Board::BINARY_MAGIC) {
+			Board board;
+			total ++;
+			if (!board.load(file)) continue;
+			if (solve_board(board, options, out, total_ms)) solved ++;
+		} else solve_stream(in, options, out, solved, total, total_ms);
+	}
+
+	if (options.command == "grade") std::cerr << "Graded " << total << " board(s), " << solved <<
+		" without guessing, in " << total_ms << " ms";
+	else std::cerr << "Solved " << solved << " of " << total << " board(s) with " <<
+		(options.dlx ? "dlx" : "backtracking") << " in " << total_ms << " ms";
+	if (total) std::cerr << " (" << total_ms / total << " ms/board)";
+	std::cerr << "." << std::endl;
+
+	return solved == total || options.command == "grade" ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+	Options options;
+	if (!parse(argc, argv, options)) {
+		usage();
+		return 2;
+	}
+
+	// Results go to stdout, the engine log to stderr (or nowhere).
+	std::ostream out(std::cout.rdbuf());
+	std::cout.rdbuf(options.quiet ? nullptr : std::cerr.rdbuf());
+
+	if (options.command == "generate") return generate(options, out);
+	return solve(options, out);
+}
@@ -14,6 +14,8 @@
 #include <gtkmm.h>
 #include <cairomm/context.h>
 
+#include <vector>
+
 class SudokuApp;
 
 /**
@@ -55,6 +57,47 @@ public:
 	 */
 	void chosen_a_number(const unsigned number);
 
+	/**
+	 * @brief Sets the notes mode: the chosen numbers toggle the pencil
+	 * marks of the selected cell instead of setting its value.
+	 */
+	void set_notes_mode(const bool notes_mode) { this->notes_mode = notes_mode; }
+
+	/**
+	 * @brief Reverts the last move and selects its cell.
+	 * 
+	 */
+	void undo();
+
+	/**
+	 * @brief Plays again the last undone move and selects its cell.
+	 * 
+	 */
+	void redo();
+
+	/**
+	 * @brief Selects the cell of a hint and highlights the cells that
+	 * explain it, until the next click or move.
+	 * 
+	 * @param x x coord of the hint cell.
+	 * @param y y coord of the hint cell.
+	 * @param error true if the hint cell holds a wrong value.
+	 * @param cells indexes (y * width + x) of the cells to highlight.
+	 */
+	void show_hint(const int x, const int y, const bool error,
+			const std::vector<unsigned> &cells);
+
+	/**
+	 * @brief Removes the highlight of the last hint.
+	 */
+	void clear_hint();
+
+	/**
+	 * @brief Forgets a digit typed as the first of a two digit value,
+	 * without playing it (the board changed).
+	 */
+	void clear_pending_digit();
+
 private:
 	SudokuApp *app; /** < Application instance. */
 
@@ -82,6 +125,31 @@ private:
 	 */
 	bool on_area_key_press(GdkEventKey *event);
 
+	/**
+	 * @brief Queues the redraw of the cells from x0, y0 to x1, y1 (included).
+	 * Nothing is queued when x0 or y0 is -1 (no cell).
+	 */
+	void queue_draw_cells(const int x0, const int y0, const int x1, const int y1);
+
+	/**
+	 * @brief Queues the redraw of the row, column and square of a cell:
+	 * a new value can change the repeated values in all of them.
+	 */
+	void queue_draw_peers(const int x, const int y);
+
+	/**
+	 * @brief Plays the digit typed as the first of a two digit value on
+	 * its own: no second digit came within a second, or another action
+	 * came first.
+	 * 
+	 * @return false ever, to stop the timeout.
+	 */
+	bool play_pending_digit();
+
 	int sel_x, sel_y; /** < Selected cell coord. */
 	bool error{};
+	bool notes_mode{}; /** < Numbers toggle pencil marks. */
+	unsigned pending_digit{}; /** < Digit typed as the first of a two digit value, not played yet. */
+	sigc::connection pending_timeout; /** < Plays the pending digit on its own. */
+	std::vector<bool> highlight; /** < Cells of the last hint. */
 };
@@ -56,6 +56,11 @@ public:
 	 */
 	Board(const Board &board);
 
+	/**
+	 * @brief Copy assignment, member by member.
+	 */
+	Board &operator=(const Board &board) = default;
+
 	/**
 	 * @brief Returns id board in format yyyyMMddhhmmss. 
 	 */
@@ -94,9 +99,44 @@ public:
 	 */
 	void set(const unsigned x, const unsigned y, const Cell cell);
 
+	/**
+	 * @brief Gets the pencil marks of a cell.
+	 * 
+	 * @return const unsigned bit (v - 1) set for each noted digit v.
+	 */
+	const unsigned get_notes(const unsigned x, const unsigned y) const {
+		return notes[y * width + x];
+	}
+
+	/**
+	 * @brief Sets the pencil marks of a cell.
+	 * 
+	 * @param notes bit (v - 1) set for each noted digit v.
+	 */
+	void set_notes(const unsigned x, const unsigned y, const unsigned notes) {
+		this->notes[y * width + x] = notes;
+	}
+
+	/**
+	 * @brief Removes the note of the digit v from the row, column and
+	 * square of the cell xy (after placing v in it).
+	 */
+	void prune_notes(const unsigned x, const unsigned y, const unsigned v);
+
+	/**
+	 * @brief Removes all the pencil marks.
+	 */
+	void clear_notes();
+
+	/**
+	 * @brief Returns true when a cell has pencil marks.
+	 */
+	const bool has_notes() const;
+
 	/**
 	 * @brief Checks a board position xy if its value does not repeat
 	 * horizontally, vertically, or in the square area.
+	 * Constant time: the board keeps the count of each value per unit.
 	 * 
 	 * @param x X coordinate of the value.
 	 * @param y Y coordinate of the value.
@@ -105,18 +145,30 @@ public:
 	 */
 	const bool is_valid(const unsigned x, const unsigned y) const;
 
+	/**
+	 * @brief Returns the number of repeated values: each extra copy of
+	 * a value in a row, column or square counts once.
+	 */
+	const unsigned get_conflicts() const { return conflicts; }
+
+	/**
+	 * @brief Returns true when the board is full and no value repeats.
+	 */
+	const bool is_solved() const { return full() && !conflicts; }
+
 	/**
 	 * @brief Returns true when the board is full.
 	 */
-	const bool full() const;
+	const bool full() const { return filled == board.size(); }
 
 	/**
 	 * @brief Returns true when the board is clear.
 	 */
-	const bool empty() const;
+	const bool empty() const { return !filled; }
 
 	/**
 	 * @brief Resets the board with the original fixed numbers.
+	 * The pencil marks are removed.
 	 * 
 	 */
 	void reset();
@@ -140,18 +192,42 @@ public:
 	const bool operator!=(const Board &board) const;
 
 	/**
-	 * @brief Loads the board from an xml file.
+	 * @brief Board file formats.
+	 * 
+	 */
+	enum class Format {
+		XML, /** Readable xml document. */
+		BINARY /** Compact binary record (BINARY_VERSION). */
+	};
+
+	static constexpr unsigned char BINARY_VERSION = 2; /** Binary format version. */
+	static constexpr const char *BINARY_MAGIC = "SDKB"; /** First bytes of the binary files. */
+
+	/**
+	 * @brief Loads the board from a file, xml or binary (detected
+	 * from the first bytes).
 	 * 
 	 * @param path File path.
+	 * @return false if the file cannot be read (the board is not changed).
 	 */
-	void load(const std::string path);
+	const bool load(const std::string path);
 
 	/**
-	 * @brief Saves the board to an xml file.
+	 * @brief Saves the board to a file. The file is replaced at once
+	 * (temporary file, fsync and rename).
 	 * 
 	 * @param path File path.
+	 * @param format file format.
+	 * @return false if the file cannot be written.
 	 */
-	void save(const std::string path);
+	const bool save(const std::string path, const Format format = Format::XML) const;
+
+	/**
+	 * @brief Returns the content of the board file.
+	 * 
+	 * @param format file format.
+	 */
+	const std::string serialize(const Format format) const;
 
 	/**
 	 * @brief Returns the formatted name from board id. 
@@ -182,6 +258,24 @@ public:
 	/** Return the board height squares count */
 	const unsigned get_sh() const { return this->sh; }
 
+	/**
+	 * @brief Returns true when a board size (number of cells) can be
+	 * played and solved: 4x4, 6x6, 9x9, 16x16 or 25x25.
+	 */
+	static const bool is_supported_size(const unsigned size);
+
+	/**
+	 * @brief Returns the character of a value in the texts with a
+	 * character per cell: '0' to '9', then 'A' (10) to 'P' (25).
+	 */
+	static const char symbol(const unsigned value);
+
+	/**
+	 * @brief Returns the value of a character of symbol(), upper or
+	 * lower case. Unknown characters are returned as 0 (empty cell).
+	 */
+	static const unsigned symbol_value(const char symbol);
+
 	void print() const;
 
 private:
@@ -192,9 +286,78 @@ private:
 
 	std::vector<Cell> board; /** The Sudoku board */
 
+	std::vector<unsigned> counts; /** Count of each value per unit (rows, columns, squares). */
+	unsigned conflicts{}; /** Repeated values. */
+	unsigned filled{}; /** Cells with a value. */
+	std::vector<unsigned> notes; /** Pencil marks of each cell, bit (v - 1) for the digit v. */
+
 	/**
-	 * @brief Set the board sizes
+	 * @brief Set the board sizes: the width and the squares, as close
+	 * to square as the width allows (3 wide and 2 high for 6x6 boards).
 	 * 
 	 */
 	void configure_sizes();
+
+	/**
+	 * @brief Decodes an xml board document.
+	 * 
+	 * @param data file content.
+	 * @return false if the document cannot be parsed.
+	 */
+	const bool load_xml(const std::string &data);
+
+	/**
+	 * @brief Returns the board as an xml document.
+	 */
+	const std::string to_xml() const;
+
+	/**
+	 * @brief Decodes a binary board record.
+	 * 
+	 * @param data file content.
+	 * @return false if the record is truncated or has another version.
+	 */
+	const bool load_binary(const std::string &data);
+
+	/**
+	 * @brief Returns the board as a binary record.
+	 * Layout: "SDKB", version, size (2 bytes, little endian), difficulty
+	 * (0: none, 1-3: Easy to Hard, 255: followed by its name), flags
+	 * (bit 0: solved mark, bit 1: notes), id, fixed cells bitmap, the
+	 * values packed with the bits needed for the board width, and the
+	 * notes when present (width bits per cell). Strings are stored as
+	 * length (1 byte) and characters. Version 1 has no notes.
+	 */
+	const std::string to_binary() const;
+
+	/**
+	 * @brief Returns the count of the value v in the unit u.
+	 */
+	unsigned &count(const unsigned u, const unsigned v) { return counts[u * (width + 1) + v]; }
+
+	/**
+	 * @brief Returns the count of the value v in the unit u.
+	 */
+	const unsigned count(const unsigned u, const unsigned v) const {
+		return counts[u * (width + 1) + v];
+	}
+
+	/**
+	 * @brief Returns the square index of the cell xy.
+	 */
+	const unsigned square(const unsigned x, const unsigned y) const {
+		return (y / sh) * (width / sw) + x / sw;
+	}
+
+	/**
+	 * @brief Adds or removes the value v of the cell xy to the counters.
+	 * 
+	 * @param add true to add the value, false to remove it.
+	 */
+	void count_value(const unsigned x, const unsigned y, const unsigned v, const bool add);
+
+	/**
+	 * @brief Rebuilds the counters from the cells.
+	 */
+	void recount();
 };
@@ -0,0 +1,172 @@
+/**
+ * @file collection-index.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Index of the boards saved in a player collection.
+ * @date 2024-10-02
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <board.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Summary of a saved board.
+ * 
+ */
+struct CollectionEntry {
+	std::string id; /** Board id. */
+	unsigned size{81}; /** Board size. */
+	std::string difficulty; /** Difficulty level. */
+	bool solved{}; /** Solved mark. */
+	long long played{}; /** Last save time (seconds since epoch). */
+	std::string givens; /** Fixed values, one char per cell (Board::symbol()). */
+	std::string values; /** Current values, one char per cell (Board::symbol()). */
+
+	/**
+	 * @brief Builds the summary of a board.
+	 */
+	static CollectionEntry from_board(const Board &board);
+
+	/**
+	 * @brief Builds the board of the summary, without reading its file.
+	 */
+	Board to_board() const;
+};
+
+/**
+ * @brief Orders of the collection boards.
+ * 
+ */
+enum class CollectionSort {
+	ID, /** Newest first (the id is the creation time). */
+	DIFFICULTY, /** Easy to Hard, then newest first. */
+	SOLVED, /** Unsolved first, then newest first. */
+	PLAYED /** Last saved first. */
+};
+
+/**
+ * @brief Index of a player collection, stored next to the collection
+ * directory (<player>/collection.idx), one board per line.
+ * update() and remove() change the entries in memory, save() (or a
+ * SaveQueue with serialize()) writes the index at once. The index is
+ * rebuilt from the board files when the collection directory is newer
+ * than the index.
+ * 
+ */
+class CollectionIndex {
+public:
+	/**
+	 * @brief Construct a new CollectionIndex.
+	 * 
+	 * @param path player directory (ending with '/').
+	 */
+	CollectionIndex(const std::string path) : path{path} {}
+
+	/**
+	 * @brief Returns the player directory.
+	 */
+	const std::string get_path() const { return path; }
+
+	/**
+	 * @brief Returns the collection directory.
+	 */
+	const std::string get_collection_path() const { return path + "collection/"; }
+
+	/**
+	 * @brief Returns the file of a board: the binary file (<id>.board),
+	 * or the xml file of older versions (<id>.xml) when only that exists.
+	 */
+	const std::string get_board_file(const std::string id) const;
+
+	/**
+	 * @brief Reads the index, rebuilding it when it is missing or stale.
+	 * Only the first call reads it; calls from other threads meanwhile
+	 * wait for it.
+	 */
+	void load();
+
+	/**
+	 * @brief Rebuilds the index reading every board file.
+	 */
+	void rebuild();
+
+	/**
+	 * @brief Returns true when the index file is missing or older than
+	 * the collection directory (boards added or removed by others).
+	 */
+	const bool is_stale() const;
+
+	/**
+	 * @brief Adds or replaces the entry of a board.
+	 */
+	void update(const Board &board);
+
+	/**
+	 * @brief Removes the entry of a board.
+	 */
+	void remove(const std::string id);
+
+	/**
+	 * @brief Returns the index file path.
+	 */
+	const std::string get_index_path() const { return path + "collection.idx"; }
+
+	/**
+	 * @brief Returns the content of the index file.
+	 */
+	const std::string serialize() const;
+
+	/**
+	 * @brief Writes the index file at once (temporary file, fsync and rename).
+	 * 
+	 * @return false if the file cannot be written.
+	 */
+	const bool save() const;
+
+	/**
+	 * @brief Returns the entries.
+	 */
+	const std::vector<CollectionEntry> get_entries() const;
+
+	/**
+	 * @brief Finds the entry of a board id.
+	 * 
+	 * @return false if the board is not in the collection.
+	 */
+	const bool find(const std::string id, CollectionEntry &entry) const;
+
+	/**
+	 * @brief Sorts the entries by a key without moving them.
+	 * 
+	 * @param entries entries to sort.
+	 * @param key sort order.
+	 * @return std::vector<unsigned> positions of the entries in order.
+	 */
+	static std::vector<unsigned> sort(const std::vector<CollectionEntry> &entries,
+			const CollectionSort key);
+
+private:
+	std::string path; /** Player directory. */
+	std::vector<CollectionEntry> entries; /** Boards of the collection. */
+	mutable std::mutex mutex; /** Guards the entries and the index file. */
+	std::mutex load_mutex; /** Guards loaded. */
+	bool loaded{}; /** The index was read or rebuilt. */
+
+	/**
+	 * @brief Reads the index file.
+	 * 
+	 * @return false if the file is missing or has another version.
+	 */
+	const bool read();
+
+	/**
+	 * @brief Returns the content of the index file, the mutex locked.
+	 */
+	const std::string serialize_entries() const;
+};
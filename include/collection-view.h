@@ -0,0 +1,125 @@
+/**
+ * @file collection-view.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Scrollable grid of board thumbnails.
+ * @date 2024-09-30
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <gtkmm.h>
+
+#include <board.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Draws the boards of the collection as tiles (thumbnail, name,
+ * difficulty and solved mark). Only the tiles inside the scrolled area
+ * are drawn. The boards arrive after the ids, in batches: the tiles
+ * without a board are drawn as placeholders until it is added.
+ * 
+ */
+class CollectionView: public Gtk::DrawingArea {
+public:
+	/**
+	 * @brief Construct a new CollectionView
+	 * 
+	 * @param obj base object.
+	 * @param builder ui builder (with the "collection-scrollbar").
+	 */
+	CollectionView(BaseObjectType* obj, Glib::RefPtr<Gtk::Builder> const& builder);
+
+	/**
+	 * @brief Sets the boards to show, in order. The boards are added
+	 * later with add_boards().
+	 * 
+	 * @param ids board ids.
+	 */
+	void set_items(const std::vector<std::string> &ids);
+
+	/**
+	 * @brief Shows the same boards in another order, keeping the loaded
+	 * boards and the selection.
+	 * 
+	 * @param ids board ids in the new order.
+	 */
+	void reorder_items(const std::vector<std::string> &ids);
+
+	/**
+	 * @brief Adds loaded boards, matched to the tiles by id.
+	 * Only the tiles on screen are redrawn.
+	 * 
+	 * @param boards loaded boards.
+	 */
+	void add_boards(const std::vector<Board> &boards);
+
+	/**
+	 * @brief Removes a board without reloading the others.
+	 */
+	void remove_item(const std::string &id);
+
+	/**
+	 * @brief Returns the id of the selected board, "" when none.
+	 */
+	const std::string get_selected() const;
+
+	/**
+	 * @brief Signal emitted when the selection changes.
+	 */
+	sigc::signal<void> signal_selection_changed() { return selection_changed; }
+
+private:
+	static constexpr int THUMB = 150; /** Thumbnail size. */
+	static constexpr int TILE_W = THUMB + 20; /** Tile width. */
+	static constexpr int TILE_H = THUMB + 50; /** Tile height (thumbnail and labels). */
+	static constexpr int SPACING = 10; /** Space between the tiles. */
+
+	Gtk::Scrollbar *scrollbar; /** Vertical scrollbar. */
+	std::vector<std::string> ids; /** Boards in order. */
+	std::unordered_map<std::string, Board> thumbnails; /** Boards loaded. */
+	int selected{-1}; /** Selected index, -1 for none. */
+	sigc::signal<void> selection_changed; /** Selection changed signal. */
+
+	/**
+	 * @brief Returns the number of tile columns for the current width.
+	 */
+	const int get_columns() const;
+
+	/**
+	 * @brief Updates the scroll range with the number of boards and the size.
+	 */
+	void update_scroll();
+
+	/**
+	 * @brief Returns the board of an index.
+	 * 
+	 * @return nullptr if the board is not loaded yet.
+	 */
+	const Board *get_board(const unsigned index) const;
+
+	/**
+	 * @brief On draw: draws the visible tiles.
+	 */
+	bool on_area_draw(const Cairo::RefPtr<Cairo::Context>& cr);
+
+	/**
+	 * @brief Draws the tile of an index at x, y.
+	 */
+	void draw_tile(const Cairo::RefPtr<Cairo::Context>& cr, const unsigned index,
+			const double x, const double y);
+
+	/**
+	 * @brief On click: selects the tile under the pointer.
+	 */
+	bool on_area_click(GdkEventButton *event);
+
+	/**
+	 * @brief On mouse wheel: scrolls the tiles.
+	 */
+	bool on_area_scroll(GdkEventScroll *event);
+};
@@ -0,0 +1,158 @@
+/**
+ * @file compact-board.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Fixed size board representation for the solver and generator.
+ * @date 2024-09-06
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <board.h>
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <assert.h>
+
+/**
+ * @brief Board values in a fixed size array: a byte per value and a
+ * bitset with the fixed cells. It lives on the stack and copies as
+ * plain memory, unlike Board (heap allocated cells and an id string).
+ * 
+ * @tparam SW width of the squares.
+ * @tparam SH height of the squares.
+ */
+template <unsigned SW, unsigned SH>
+class CompactBoard {
+public:
+	static constexpr unsigned SQUARE_W = SW; /** Width of the squares. */
+	static constexpr unsigned SQUARE_H = SH; /** Height of the squares. */
+	static constexpr unsigned WIDTH = SW * SH; /** Board width. */
+	static constexpr unsigned SIZE = WIDTH * WIDTH; /** Number of cells. */
+
+	/**
+	 * @brief Construct an empty board.
+	 */
+	CompactBoard() = default;
+
+	/**
+	 * @brief Construct a compact copy of the values and fixed cells of a board.
+	 * 
+	 * @param board Board with the same square sizes.
+	 */
+	explicit CompactBoard(const Board &board) {
+		assert(board.get_sw() == SW && board.get_sh() == SH && "Compact board: Geometry mismatch.");
+		for (unsigned i = 0; i < SIZE; i ++) {
+			auto cell = board.get(i % WIDTH, i / WIDTH);
+			set(i, cell.value);
+			set_fixed(i, cell.fixed);
+		}
+	}
+
+	/**
+	 * @brief Copies the values and fixed cells into a board.
+	 * 
+	 * @param board Board with the same square sizes.
+	 */
+	void store(Board &board) const {
+		assert(board.get_sw() == SW && board.get_sh() == SH && "Compact board: Geometry mismatch.");
+		for (unsigned i = 0; i < SIZE; i ++)
+			board.set(i % WIDTH, i / WIDTH, {get(i), is_fixed(i)});
+	}
+
+	using Unit = std::array<std::uint16_t, WIDTH>; /** Cells of a row, column or square. */
+
+	/**
+	 * @brief Returns the square index of the cell i.
+	 */
+	static const unsigned square(const unsigned i) {
+		return (i / WIDTH / SH) * SH + (i % WIDTH) / SW;
+	}
+
+	/**
+	 * @brief Returns the units of the cell i: its row, column and square
+	 * as indexes of units().
+	 */
+	static const std::array<unsigned, 3> units_of(const unsigned i) {
+		return {i / WIDTH, WIDTH + i % WIDTH, 2 * WIDTH + square(i)};
+	}
+
+	/**
+	 * @brief Returns the cells of every unit: the rows first,
+	 * then the columns and the squares.
+	 */
+	static const std::array<Unit, 3 * WIDTH> &units() {
+		static const auto table = [] {
+			std::array<Unit, 3 * WIDTH> table{};
+			std::array<unsigned, 3 * WIDTH> count{};
+			for (unsigned i = 0; i < SIZE; i ++) {
+				for (auto u : units_of(i)) table[u][count[u] ++] = i;
+			}
+			return table;
+		}();
+		return table;
+	}
+
+	/**
+	 * @brief Returns the value of the cell i (0 for empty cell).
+	 */
+	const unsigned get(const unsigned i) const { return values[i]; }
+
+	/**
+	 * @brief Sets the value of the cell i.
+	 */
+	void set(const unsigned i, const unsigned v) { values[i] = std::uint8_t(v); }
+
+	/**
+	 * @brief Returns true when the cell i is fixed.
+	 */
+	const bool is_fixed(const unsigned i) const { return (fixed[i / 64] >> (i % 64)) & 1; }
+
+	/**
+	 * @brief Marks or unmarks the cell i as fixed.
+	 */
+	void set_fixed(const unsigned i, const bool f) {
+		if (f) fixed[i / 64] |= std::uint64_t(1) << (i % 64);
+		else fixed[i / 64] &= ~(std::uint64_t(1) << (i % 64));
+	}
+
+	/**
+	 * @brief Compares the values of two boards.
+	 */
+	const bool operator==(const CompactBoard &board) const { return values == board.values; }
+
+	/**
+	 * @brief Compares the values of two boards.
+	 */
+	const bool operator!=(const CompactBoard &board) const { return values != board.values; }
+
+private:
+	std::array<std::uint8_t, SIZE> values{}; /** Cell values (0 for empty cell). */
+	std::array<std::uint64_t, (SIZE + 63) / 64> fixed{}; /** Fixed cells, a bit per cell. */
+};
+
+static_assert(std::is_trivially_copyable<CompactBoard<3, 3>>::value,
+		"CompactBoard must copy as plain memory.");
+
+/**
+ * @brief Calls the visitor with an empty CompactBoard of the given
+ * square sizes, to run templated code on a runtime board geometry.
+ * The geometries are the ones of Board::is_supported_size(): 2x2, 3x2
+ * (6x6 boards), 3x3, 4x4 and 5x5 squares.
+ * 
+ * @param sw width of the squares.
+ * @param sh height of the squares.
+ * @param visitor generic callable taking the CompactBoard by value.
+ * @return the visitor result.
+ */
+template <class Visitor>
+auto visit_compact(const unsigned sw, const unsigned sh, Visitor &&visitor) {
+	if (sw == 2 && sh == 2) return visitor(CompactBoard<2, 2>());
+	if (sw == 3 && sh == 2) return visitor(CompactBoard<3, 2>());
+	if (sw == 4 && sh == 4) return visitor(CompactBoard<4, 4>());
+	if (sw == 5 && sh == 5) return visitor(CompactBoard<5, 5>());
+	assert(sw == 3 && sh == 3 && "Compact board: Unsupported geometry.");
+	return visitor(CompactBoard<3, 3>());
+}
@@ -67,7 +67,33 @@ public:
 	 */
 	static const std::string get_config_path() { return config_path; }
 
+	/**
+	 * @brief Returns the number of board generator threads.
+	 * 0: one per hardware thread.
+	 */
+	static const unsigned get_generator_workers() { return generator_workers; }
+
+	/**
+	 * @brief Sets the number of board generator threads.
+	 * 0: one per hardware thread.
+	 */
+	static void set_generator_workers(const unsigned workers) { generator_workers = workers; }
+
+	/**
+	 * @brief Returns the number of pre-generated boards kept for each
+	 * size and difficulty.
+	 */
+	static const unsigned get_pool_watermark() { return pool_watermark; }
+
+	/**
+	 * @brief Sets the number of pre-generated boards kept for each
+	 * size and difficulty.
+	 */
+	static void set_pool_watermark(const unsigned watermark) { pool_watermark = watermark; }
+
 private:
 	static std::string config_path; /**< Path to the configuration directory */
 	static std::string current_player; /**< Name of the current player */
+	static unsigned generator_workers; /**< Board generator threads (0: auto) */
+	static unsigned pool_watermark; /**< Pre-generated boards per size and difficulty */
 };
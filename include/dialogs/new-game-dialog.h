@@ -47,5 +47,5 @@ public:
 private:
 	/** Radio buttons */
 	Gtk::RadioButton *easy_option, *medium_option, *hard_option;
-	Gtk::RadioButton *x81_option, *x16_option;
+	Gtk::RadioButton *x81_option, *x16_option, *x36_option, *x256_option, *x625_option;
 };
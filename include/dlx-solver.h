@@ -0,0 +1,93 @@
+/**
+ * @file dlx-solver.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Exact cover Sudoku solver (Dancing Links).
+ * @date 2024-09-02
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <board.h>
+
+#include <list>
+#include <vector>
+
+/**
+ * @brief Solve a Sudoku board as an exact cover problem with
+ * Knuth's Algorithm X over dancing links.
+ * Every (cell, value) candidate is a row that covers four columns:
+ * the cell, the value in the row, the value in the column and the
+ * value in the square (4 x N² columns for a N x N board).
+ * 
+ */
+class DlxSolver {
+public:
+	/**
+	 * @brief Solve a Sudoku board and return the solutions.
+	 * 
+	 * @param board Board to solve.
+	 * @param max_solutions maximum of solutions to find. -1 to all.
+	 * @return std::list<Board> list of solutions.
+	 */
+	static std::list<Board> solve(const Board &board, const unsigned max_solutions);
+
+	/**
+	 * @brief Counts the solutions of a Sudoku board.
+	 * 
+	 * @param board Board to solve.
+	 * @param limit stop counting when this number is reached. -1 to all.
+	 * @return const unsigned the number of solutions found.
+	 */
+	static const unsigned count(const Board &board, const unsigned limit);
+
+private:
+	/**
+	 * @brief Sparse exact cover matrix as a toroidal doubly linked list.
+	 * Node 0 is the root, nodes 1..columns are the column headers and the
+	 * rest are the candidate nodes, four per candidate row.
+	 * 
+	 */
+	struct Matrix {
+		std::vector<unsigned> left, right, up, down; /** Node links. */
+		std::vector<unsigned> column; /** Column header of each node. */
+		std::vector<unsigned> row; /** Candidate of each node: cell * width + value - 1. */
+		std::vector<unsigned> size; /** Number of nodes of each column. */
+	};
+
+	/**
+	 * @brief Builds the exact cover matrix of the board.
+	 * Given cells only get the row of their value and empty cells the
+	 * rows of the values not used by the givens of their units.
+	 * 
+	 * @param board Board to encode.
+	 * @param matrix Matrix to fill.
+	 */
+	static void build(const Board &board, Matrix &matrix);
+
+	/**
+	 * @brief Removes the column c and all the rows that cover it.
+	 */
+	static void cover(Matrix &matrix, const unsigned c);
+
+	/**
+	 * @brief Restores the column c and all the rows that cover it.
+	 */
+	static void uncover(Matrix &matrix, const unsigned c);
+
+	/**
+	 * @brief Internal recursive Algorithm X search.
+	 * 
+	 * @param matrix Exact cover matrix.
+	 * @param chosen Nodes of the rows chosen so far.
+	 * @param board Board to solve, used as model for the solutions.
+	 * @param solutions solutions found, nullptr to only count them.
+	 * @param found number of solutions found.
+	 * @param limit maximum of solutions to find. -1 to all.
+	 * @return true if all solutions were found.
+	 */
+	static const bool search(Matrix &matrix, std::vector<unsigned> &chosen,
+			const Board &board, std::list<Board> *solutions, unsigned &found,
+			const unsigned limit);
+};
@@ -0,0 +1,126 @@
+/**
+ * @file generator-pool.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Background board generation on a pool of worker threads.
+ * @date 2024-09-10
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <board.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A generated board and its solution.
+ * 
+ */
+struct GeneratedBoard {
+	Board board; /** Board to play, empty when the generation was cancelled. */
+	Board solved; /** Solution of the board. */
+};
+
+/**
+ * @brief Pool of worker threads that generates boards off the calling
+ * thread. Each request races several random seeds on the workers and
+ * the first unique board found wins; the other racers are cancelled.
+ * 
+ */
+class GeneratorPool {
+public:
+	/**
+	 * @brief Construct a new GeneratorPool and start its workers.
+	 * 
+	 * @param workers number of worker threads. 0: one per hardware thread.
+	 */
+	GeneratorPool(const unsigned workers = 0);
+
+	/**
+	 * @brief Cancel the pending requests and join the workers.
+	 * The futures of the pending requests get an empty board.
+	 */
+	~GeneratorPool();
+
+	GeneratorPool(const GeneratorPool &) = delete;
+	GeneratorPool &operator=(const GeneratorPool &) = delete;
+
+	/**
+	 * @brief Request a new board.
+	 * 
+	 * @param size the size of the board.
+	 * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+	 * @param ready called from the winning worker thread once the board
+	 * is available in the future (can be empty).
+	 * @param racers number of seeds raced. 0: one per worker.
+	 * @return std::future<GeneratedBoard> the generated board and its solution.
+	 */
+	std::future<GeneratedBoard> generate(const unsigned size, const unsigned difficulty,
+			std::function<void()> ready = nullptr, const unsigned racers = 0);
+
+	/**
+	 * @brief Cancel the pending requests: their racers stop and their
+	 * futures get an empty board.
+	 */
+	void cancel();
+
+	/**
+	 * @brief Request the solution of a board, solved on a worker.
+	 * 
+	 * @param board board to solve, from its fixed values.
+	 * @param ready called from the worker thread once the solution is
+	 * available in the future.
+	 * @return std::future<Board> the solution, an empty board when the
+	 * board has none.
+	 */
+	std::future<Board> solve(const Board &board, std::function<void()> ready = nullptr);
+
+	/**
+	 * @brief Returns the number of worker threads.
+	 */
+	const unsigned get_workers() const { return threads.size(); }
+
+private:
+	/**
+	 * @brief Shared state of the racers of one request.
+	 * 
+	 */
+	struct Race {
+		unsigned size{}, difficulty{}; /** Requested board. */
+		std::atomic<bool> done{}; /** Set by the winner, cancels the others. */
+		std::atomic<unsigned> running{}; /** Racers not finished yet. */
+		std::promise<GeneratedBoard> promise; /** Result of the request. */
+		std::function<void()> ready; /** Result ready callback. */
+	};
+
+	/**
+	 * @brief Runs one racer of a request on a worker thread.
+	 * 
+	 * @param race the request.
+	 * @param seed random seed of this racer.
+	 */
+	static void run_racer(std::shared_ptr<Race> race, const unsigned seed);
+
+	/**
+	 * @brief Worker thread loop.
+	 * 
+	 */
+	void run_worker();
+
+	std::vector<std::thread> threads; /** Worker threads. */
+	std::deque<std::function<void()>> tasks; /** Pending racers. */
+	std::list<std::weak_ptr<Race>> races; /** Requests to cancel. */
+	std::mutex mutex; /** Guards tasks and races. */
+	std::condition_variable condition; /** Wakes the workers. */
+	std::atomic<bool> stopping{}; /** True when the pool is shutting down: the queued tasks only release their futures. */
+};
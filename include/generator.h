@@ -10,7 +10,10 @@
 
 #pragma once
 
-class Board;
+#include <compact-board.h>
+
+#include <atomic>
+#include <string>
 
 /**
  * @brief Board generator for Sudoku game.
@@ -27,24 +30,68 @@ public:
 	 * @param visible_numbers expected visible values.
 	 * @param solutions number of solutions of the board.
  	 * @param size the size of the board.
+	 * @param cancel when set to true, the generation stops and returns
+	 * an empty board.
 	 * @return Board the generated board.
 	 */
 	static Board generate_board(const unsigned visible_numbers, const unsigned solutions,
-		const unsigned size);
+		const unsigned size, const std::atomic<bool> *cancel = nullptr);
+
+	/**
+	 * @brief Generates a new Sudoku board rated by the grader at the given
+	 * difficulty level, with a single solution.
+	 * Numbers are removed while the grader solves the board without
+	 * guessing and the rating stays at the level or below, until the
+	 * level is reached with no more than visible_numbers() left: Hard
+	 * boards need up to X-wings, on every size. After a few boards that
+	 * miss the level (small boards have few Hard ratings), the closest
+	 * one is returned.
+	 * 
+	 * @param size the size of the board.
+	 * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+	 * @param cancel when set to true, the generation stops and returns
+	 * an empty board.
+	 * @param solved when not nullptr, receives the solution of the board:
+	 * the full board the numbers were removed from.
+	 * @return Board the generated board.
+	 */
+	static Board generate_graded(const unsigned size, const unsigned difficulty,
+		const std::atomic<bool> *cancel = nullptr, Board *solved = nullptr);
+
+	/**
+	 * @brief Returns a random count of visible numbers for a difficulty level.
+	 * 
+	 * @param size the size of the board.
+	 * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+	 */
+	static const unsigned visible_numbers(const unsigned size, const unsigned difficulty);
+
+	/**
+	 * @brief Returns the name of a difficulty level.
+	 * 
+	 * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+	 */
+	static const std::string difficulty_name(const unsigned difficulty);
 
 	/**
 	 * @brief Returns a randomly generated integer between min and max.
 	 */
 	static const int rand_int(const int min, const int max);
 
+	/**
+	 * @brief Seeds the random generator of the calling thread.
+	 * Each thread has its own random generator.
+	 */
+	static void seed(const unsigned seed);
+
 private:
 	/**
 	 * @brief Generates a new fully board with randomized values.
 	 * The board is validated with the Sudoku's rules.
- 	 * @param size the size of the board.
-	 * @return Board The generated board.
+	 * @return CompactBoard The generated board.
 	 */
-	static Board fill_board(const unsigned size);
+	template <unsigned SW, unsigned SH>
+	static CompactBoard<SW, SH> fill_board();
 
 	/**
 	 * @brief Returns the number of cells with the value = 0 of the board.
@@ -58,9 +105,27 @@ private:
 	 * @param generated Resulting board.
 	 * @param vn Number of visible numbers.
 	 * @param solutions Expected number of solutions.
+	 * @param cancel stops the search when set to true (can be nullptr).
 	 * @return true When a board meeting the conditions is found.
 	 * @return false The board does not meet the conditions and continues searching.
 	 */
-	static const bool generate_board(Board generating, Board &generated,
-			const unsigned vn, const unsigned solutions);
+	template <unsigned SW, unsigned SH>
+	static const bool generate_board(CompactBoard<SW, SH> generating,
+			CompactBoard<SW, SH> &generated, const unsigned vn, const unsigned solutions,
+			const std::atomic<bool> *cancel);
+
+	/**
+	 * @brief Removes numbers from a full board in random order, keeping
+	 * the ones that would rate the board above the difficulty level
+	 * or make the grader guess.
+	 * 
+	 * @param board Board to remove numbers from.
+	 * @param vn Number of visible numbers to stop at once the level is reached.
+	 * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+	 * @param cancel stops the removal when set to true (can be nullptr).
+	 * @return the difficulty level of the resulting board.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const unsigned remove_graded(CompactBoard<SW, SH> &board, const unsigned vn,
+			const unsigned difficulty, const std::atomic<bool> *cancel);
 };
@@ -0,0 +1,221 @@
+/**
+ * @file grader.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Sudoku difficulty grader module.
+ * @date 2024-09-24
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <board.h>
+#include <compact-board.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Human solving techniques, from the easiest to the hardest.
+ * 
+ */
+enum class Technique {
+	NAKED_SINGLE, /** The only candidate left in a cell. */
+	HIDDEN_SINGLE, /** The only cell left for a digit in a unit. */
+	LOCKED_CANDIDATES, /** A digit of a unit confined to the cells shared with another unit. */
+	NAKED_PAIR, /** Two cells of a unit with the same two candidates. */
+	HIDDEN_PAIR, /** Two digits confined to the same two cells of a unit. */
+	NAKED_TRIPLE, /** Three cells of a unit with three candidates between them. */
+	HIDDEN_TRIPLE, /** Three digits confined to the same three cells of a unit. */
+	X_WING, /** A digit in two cells of two rows, on the same two columns (or the other way). */
+	GUESS /** None of the above applies: the board needs trial and error. */
+};
+
+/**
+ * @brief A deduction made by the grader.
+ * Cells are indexes of the board (y * width + x).
+ * 
+ */
+struct GradeStep {
+	Technique technique{Technique::NAKED_SINGLE}; /** Technique applied. */
+	unsigned cell{}; /** Cell filled (singles). */
+	unsigned value{}; /** Value filled, 0 when the step only removes candidates. */
+	unsigned digits{}; /** Digits of the pattern, bit (v - 1) for the digit v. */
+	std::vector<unsigned> cells; /** Cells of the pattern. */
+	std::vector<unsigned> eliminated; /** Cells that lost candidates. */
+};
+
+/**
+ * @brief Rating of a board.
+ * 
+ */
+struct Grade {
+	Technique hardest{Technique::NAKED_SINGLE}; /** Hardest technique needed. */
+	unsigned steps{}; /** Deductions made. */
+	unsigned rating{}; /** Weight of the hardest technique * 100 + steps. */
+
+	/**
+	 * @brief Returns true when the techniques solve the whole board.
+	 */
+	const bool is_solved() const { return hardest != Technique::GUESS; }
+};
+
+/**
+ * @brief Rates a Sudoku board by solving it as a person would: the
+ * easiest technique that makes progress is applied each time, until the
+ * board is full or no technique applies.
+ * A board solved by the techniques has a single solution.
+ * 
+ */
+class Grader {
+public:
+	/**
+	 * @brief Rates a board.
+	 * 
+	 * @param board Board to rate.
+	 * @param steps when not nullptr, receives the deductions in order.
+	 * @return Grade the rating.
+	 */
+	static Grade grade(const Board &board, std::vector<GradeStep> *steps = nullptr);
+
+	/**
+	 * @brief Rates a compact board.
+	 * 
+	 * @param board Board to rate.
+	 * @param steps when not nullptr, receives the deductions in order.
+	 * @return Grade the rating.
+	 */
+	template <unsigned SW, unsigned SH>
+	static Grade grade(const CompactBoard<SW, SH> &board, std::vector<GradeStep> *steps = nullptr);
+
+	/**
+	 * @brief Finds the next deduction a person would make on a board:
+	 * the easiest techniques are applied until one fills a cell.
+	 * 
+	 * @param board Board to check, with the values played so far.
+	 * @param hint receives the cell and value filled, the hardest
+	 * technique needed and the cells of the patterns that lead to it.
+	 * @return false if the board is full, has repeated values or needs guessing.
+	 */
+	static const bool hint(const Board &board, GradeStep &hint);
+
+	/**
+	 * @brief Returns the difficulty level of a rating.
+	 * 
+	 * @return 0: Easy (singles), 1: Medium (up to pairs), 2: Hard (up to
+	 * X-wings, or guessing when the board is not solved).
+	 */
+	static const unsigned difficulty(const Grade &grade);
+
+	/**
+	 * @brief Returns the weight of a technique in the rating.
+	 */
+	static const unsigned weight(const Technique technique);
+
+	/**
+	 * @brief Returns the name of a technique.
+	 */
+	static const std::string technique_name(const Technique technique);
+
+private:
+	/**
+	 * @brief Board being solved, with the candidates of each empty cell.
+	 * Bit (v - 1) is set when the digit v is a candidate.
+	 * 
+	 */
+	template <unsigned SW, unsigned SH>
+	struct Grid {
+		static constexpr unsigned WIDTH = SW * SH; /** Board width. */
+		static constexpr unsigned SIZE = WIDTH * WIDTH; /** Number of cells. */
+
+		CompactBoard<SW, SH> board; /** Cell values. */
+		std::array<unsigned, SIZE> candidates{}; /** Candidates (0 for filled cells). */
+		unsigned empty{}; /** Empty cells left. */
+	};
+
+	/**
+	 * @brief Loads the board values and computes the candidates.
+	 * 
+	 * @return false if two given values collide.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool load_grid(const CompactBoard<SW, SH> &board, Grid<SW, SH> &grid);
+
+	/**
+	 * @brief Places the value v in the cell i and removes it from the
+	 * candidates of its peers.
+	 */
+	template <unsigned SW, unsigned SH>
+	static void place(Grid<SW, SH> &grid, const unsigned i, const unsigned v);
+
+	/**
+	 * @brief Applies the easiest technique that makes progress.
+	 * 
+	 * @param grid Board being solved.
+	 * @param step when not nullptr, receives the deduction.
+	 * @return Technique the technique applied, GUESS if none applies.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const Technique apply(Grid<SW, SH> &grid, GradeStep *step);
+
+	/**
+	 * @brief Removes the digits of mask from the cells of the unit u,
+	 * except from the cells accepted by keep.
+	 * 
+	 * @return true if a candidate was removed.
+	 */
+	template <unsigned SW, unsigned SH, class Keep>
+	static const bool remove(Grid<SW, SH> &grid, const unsigned u, const unsigned mask,
+			const Keep &keep, GradeStep *step);
+
+	/**
+	 * @brief Looks for n masks of the list whose union has n bits, and
+	 * calls found with the chosen indexes (a bit per index) and the union
+	 * until it returns true.
+	 * 
+	 * @return true if found returned true.
+	 */
+	template <class Masks, class Found>
+	static const bool find_subset(const Masks &masks, const unsigned count, const unsigned n,
+			const unsigned start, const unsigned chosen, const unsigned joined, const Found &found);
+
+	/**
+	 * @brief Fills a cell with one candidate.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool naked_single(Grid<SW, SH> &grid, GradeStep *step);
+
+	/**
+	 * @brief Fills the only cell of a digit in a unit.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool hidden_single(Grid<SW, SH> &grid, GradeStep *step);
+
+	/**
+	 * @brief Removes a digit confined to the cells a unit shares with
+	 * another unit from the rest of the other unit (pointing and claiming).
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool locked_candidates(Grid<SW, SH> &grid, GradeStep *step);
+
+	/**
+	 * @brief Removes the digits of n cells of a unit with n candidates
+	 * between them from the rest of the unit.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool naked_subset(Grid<SW, SH> &grid, const unsigned n, GradeStep *step);
+
+	/**
+	 * @brief Removes the other candidates of n cells of a unit holding
+	 * the only places of n digits.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool hidden_subset(Grid<SW, SH> &grid, const unsigned n, GradeStep *step);
+
+	/**
+	 * @brief Removes a digit held by the same two columns in two rows
+	 * from the rest of the columns (and the other way around).
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool x_wing(Grid<SW, SH> &grid, GradeStep *step);
+};
@@ -0,0 +1,71 @@
+/**
+ * @file grid-cache.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Pre-rendered surfaces to draw Sudoku boards.
+ * @date 2024-09-27
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <cairomm/context.h>
+#include <cairomm/surface.h>
+
+#include <board.h>
+
+/**
+ * @brief Grid lines and digit glyphs of a board geometry rendered once
+ * for a cell size, then copied to the widgets on each draw.
+ * 
+ */
+class GridCache {
+public:
+	/**
+	 * @brief Returns the cache of a board geometry and cell size,
+	 * rendering it the first time.
+	 * 
+	 * @param cr Cairo context of the widget (the surfaces are similar to its target).
+	 * @param board Board to draw.
+	 * @param s_size cell size.
+	 * @return GridCache& the cache.
+	 */
+	static GridCache &get(const Cairo::RefPtr<Cairo::Context>& cr, const Board &board,
+			const double s_size);
+
+	/**
+	 * @brief Paints the cell borders and the square separators.
+	 */
+	void paint_lines(const Cairo::RefPtr<Cairo::Context>& cr) const;
+
+	/**
+	 * @brief Paints a digit in the cell xy.
+	 * 
+	 * @param value digit to paint.
+	 * @param fixed true for the style of the fixed values.
+	 */
+	void paint_digit(const Cairo::RefPtr<Cairo::Context>& cr, const unsigned x, const unsigned y,
+			const unsigned value, const bool fixed) const;
+
+	/**
+	 * @brief Paints the pencil marks of the cell xy, each digit at its
+	 * place in a sw x sh grid inside the cell.
+	 * 
+	 * @param notes bit (v - 1) set for each noted digit v.
+	 */
+	void paint_notes(const Cairo::RefPtr<Cairo::Context>& cr, const unsigned x, const unsigned y,
+			const unsigned notes) const;
+
+private:
+	unsigned width{}, sw{}, sh{}; /** Board geometry. */
+	double s_size{}; /** Cell size. */
+
+	Cairo::RefPtr<Cairo::Surface> lines; /** Borders and separators, transparent cells. */
+	Cairo::RefPtr<Cairo::Surface> glyphs; /** Digits: a row per style (fixed, user, notes),
+												a column per value. */
+
+	/**
+	 * @brief Renders the surfaces.
+	 */
+	void render(const Cairo::RefPtr<Cairo::Context>& cr);
+};
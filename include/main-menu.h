@@ -45,6 +45,37 @@ private:
 	 */
 	void menu_reset_board() const;
 
+	/**
+	 * @brief On Undo item click.
+	 * 
+	 */
+	void menu_undo() const;
+
+	/**
+	 * @brief On Redo item click.
+	 * 
+	 */
+	void menu_redo() const;
+
+	/**
+	 * @brief On Notes item toggle.
+	 * 
+	 * @param active true to enter the notes mode.
+	 */
+	void menu_notes(const bool active) const;
+
+	/**
+	 * @brief On Fill Notes item click.
+	 * 
+	 */
+	void menu_fill_notes() const;
+
+	/**
+	 * @brief On Hint item click.
+	 * 
+	 */
+	void menu_hint() const;
+
 	/**
 	 * @brief On Check welcome window item click;
 	 * 
@@ -0,0 +1,154 @@
+/**
+ * @file move-journal.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Log of the moves of a game, with undo and redo.
+ * @date 2024-10-06
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <board.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class SaveQueue;
+
+/**
+ * @brief Append-only log of the moves of a board.
+ * The file starts with the start values of the board, followed by one
+ * record per line: a move ("m cell old new time", then "cell:notes"
+ * for each cell whose notes it pruned), an undo ("u") or a redo ("r").
+ * Each move is persisted with a small append; compact() moves the start
+ * values to the current board and rewrites the file through the save
+ * queue with the moves that can be redone only. The moves played before
+ * the start values stay in memory, so undo reaches the whole session.
+ * 
+ */
+class MoveJournal {
+public:
+	/**
+	 * @brief A value change of a cell.
+	 * 
+	 */
+	struct Move {
+		unsigned cell; /** Cell index (y * width + x). */
+		unsigned old_value; /** Value before the move. */
+		unsigned new_value; /** Value after the move. */
+		long long time; /** Time of the move (milliseconds since epoch). */
+		std::vector<std::pair<unsigned, unsigned>> notes; /** Notes pruned by the move: cell index and notes before the move. */
+	};
+
+	static constexpr unsigned COMPACT_RECORDS = 256; /** Dropped records that trigger a compaction. */
+
+	/**
+	 * @brief Starts a new log for a board, replacing the file.
+	 * 
+	 * @param path log file path.
+	 * @param board board at the start of the log.
+	 * @param queue queue of the file writes.
+	 */
+	void start(const std::string path, const Board &board, SaveQueue &queue);
+
+	/**
+	 * @brief Opens the log of a board and replays it onto the board.
+	 * 
+	 * @param path log file path.
+	 * @param board board to update (its fixed values are kept).
+	 * @param queue queue of the file writes.
+	 * @return false if the file is missing or does not match the board
+	 * (the board is not changed).
+	 */
+	const bool open(const std::string path, Board &board, SaveQueue &queue);
+
+	/**
+	 * @brief Stops logging: the next moves are not recorded.
+	 */
+	void close();
+
+	/**
+	 * @brief Returns the log file path, "" when closed.
+	 */
+	const std::string get_path() const { return path; }
+
+	/**
+	 * @brief Sets a value on the board, removes it from the notes of
+	 * the row, column and box of the cell, and records the move.
+	 * The moves that could be redone are discarded.
+	 */
+	void play(Board &board, const unsigned x, const unsigned y, const unsigned value);
+
+	/**
+	 * @brief Reverts the last move and restores the notes it pruned.
+	 * 
+	 * @param board board to update.
+	 * @param x, y set to the cell of the move.
+	 * @return false if there is no move to undo.
+	 */
+	const bool undo(Board &board, unsigned &x, unsigned &y);
+
+	/**
+	 * @brief Plays again the last undone move.
+	 * 
+	 * @param board board to update.
+	 * @param x, y set to the cell of the move.
+	 * @return false if there is no move to redo.
+	 */
+	const bool redo(Board &board, unsigned &x, unsigned &y);
+
+	/**
+	 * @brief Returns true when there is a move to undo.
+	 */
+	const bool can_undo() const { return position > 0; }
+
+	/**
+	 * @brief Returns true when there is a move to redo.
+	 */
+	const bool can_redo() const { return position < moves.size(); }
+
+	/**
+	 * @brief Returns the number of records a compaction would drop
+	 * (applied moves, undo, redo and discarded moves).
+	 */
+	const unsigned get_records() const {
+		auto kept = 2 * (moves.size() - position);
+		return records > kept ? records - kept : 0;
+	}
+
+	/**
+	 * @brief Moves the start values to the current board and queues
+	 * the rewrite of the file with the moves that can be redone.
+	 * 
+	 * @return false if the log is closed.
+	 */
+	const bool compact();
+
+private:
+	std::string path; /** Log file, "" when closed. */
+	SaveQueue *queue{}; /** Queue of the file writes. */
+	std::string base; /** Start values of the file, one char per cell (Board::symbol()). */
+	std::vector<Move> moves; /** Moves of the session, the undone ones at the end. */
+	std::size_t first{}; /** First move in the file, the older ones are in the start values. */
+	std::size_t position{}; /** Moves applied. */
+	unsigned records{}; /** Records in the file after the start values. */
+
+	/**
+	 * @brief Appends a record to the file, or queues the rewrite of
+	 * the file while a rewrite is pending.
+	 */
+	void append(const std::string record);
+
+	/**
+	 * @brief Queues the rewrite of the file.
+	 */
+	void rewrite();
+
+	/**
+	 * @brief Returns the content of the file: the start values and the
+	 * moves played after them.
+	 */
+	const std::string serialize() const;
+};
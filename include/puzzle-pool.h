@@ -0,0 +1,89 @@
+/**
+ * @file puzzle-pool.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief On disk cache of pre-generated boards.
+ * @date 2024-09-12
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <board.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Pool of ready to play boards stored in the config directory,
+ * one file per size and difficulty (pool-<size>-<difficulty>.txt).
+ * Each line holds the givens and the solution of a board, one char
+ * per cell.
+ * A low priority thread refills every pool up to the watermark.
+ * 
+ */
+class PuzzlePool {
+public:
+	/**
+	 * @brief Construct a new PuzzlePool and start the refill thread.
+	 * 
+	 * @param path directory of the pool files (ending with '/').
+	 * @param watermark boards kept ready for each size and difficulty.
+	 */
+	PuzzlePool(const std::string path, const unsigned watermark);
+
+	/**
+	 * @brief Stop the refill thread.
+	 */
+	~PuzzlePool();
+
+	PuzzlePool(const PuzzlePool &) = delete;
+	PuzzlePool &operator=(const PuzzlePool &) = delete;
+
+	/**
+	 * @brief Takes a ready board from the pool.
+	 * 
+	 * @param size the size of the board.
+	 * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+	 * @param board the board, with a new id.
+	 * @param solved the solution of the board.
+	 * @return false if the pool is empty.
+	 */
+	const bool pop(const unsigned size, const unsigned difficulty, Board &board, Board &solved);
+
+	/**
+	 * @brief Returns the number of ready boards of a size and difficulty.
+	 */
+	const unsigned count(const unsigned size, const unsigned difficulty);
+
+private:
+	/**
+	 * @brief Returns the pool file path of a size and difficulty.
+	 */
+	const std::string file_path(const unsigned size, const unsigned difficulty) const;
+
+	/**
+	 * @brief Generates and appends a board to a pool.
+	 * 
+	 * @return false if the generation was cancelled.
+	 */
+	const bool push_new(const unsigned size, const unsigned difficulty);
+
+	/**
+	 * @brief Refill thread loop.
+	 * 
+	 */
+	void run_refill();
+
+	std::string path; /** Directory of the pool files. */
+	unsigned watermark; /** Boards kept ready for each pool. */
+
+	std::thread thread; /** Refill thread. */
+	std::mutex mutex; /** Guards the pool files. */
+	std::condition_variable condition; /** Wakes the refill thread. */
+	std::atomic<bool> stopping{}; /** True when the pool is shutting down. */
+	bool refill{}; /** True when a board was taken since the last refill. */
+};
@@ -0,0 +1,104 @@
+/**
+ * @file save-queue.h
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Background writer for the game files.
+ * @date 2024-10-04
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @brief Writes files on a worker thread. A file queued again before
+ * it is written keeps its place and only the last content is written,
+ * so rapid saves of the same file are coalesced.
+ * The content is serialized on the worker, and each file is replaced
+ * at once: temporary file, fsync and rename.
+ * 
+ */
+class SaveQueue {
+public:
+	/**
+	 * @brief Builds the content of a file, called on the worker thread.
+	 */
+	using Serializer = std::function<std::string()>;
+
+	/**
+	 * @brief Construct a new SaveQueue and start its worker.
+	 */
+	SaveQueue();
+
+	/**
+	 * @brief Write the queued files and join the worker.
+	 */
+	~SaveQueue();
+
+	SaveQueue(const SaveQueue &) = delete;
+	SaveQueue &operator=(const SaveQueue &) = delete;
+
+	/**
+	 * @brief Queues the write of a file, replacing a pending write of
+	 * the same file.
+	 * 
+	 * @param path file path.
+	 * @param serializer builds the content (must own its data).
+	 * @param last moves a pending write of the file to the end of the
+	 * queue, after the files queued since.
+	 */
+	void save(const std::string path, Serializer serializer, const bool last = false);
+
+	/**
+	 * @brief Waits until the queued files are written.
+	 */
+	void flush();
+
+	/**
+	 * @brief Returns true while a write of a file is queued or running.
+	 * @param path file path.
+	 */
+	const bool is_pending(const std::string path);
+
+	/**
+	 * @brief Returns the number of writes that failed.
+	 */
+	const unsigned get_failures() const { return failures; }
+
+	/**
+	 * @brief Replaces a file at once: writes a temporary file with a
+	 * unique name, syncs it to disk and renames it over the file. A power
+	 * loss leaves the old or the new content, never a truncated file, and
+	 * concurrent writes of a file leave one of them.
+	 * 
+	 * @param path file path.
+	 * @param data file content.
+	 * @return false if the file cannot be written (it is not changed).
+	 */
+	static const bool write_file(const std::string path, const std::string &data);
+
+private:
+	std::thread worker; /** Writer thread. */
+	std::mutex mutex; /** Guards the queue. */
+	std::condition_variable condition; /** Signals new writes and the end of writes. */
+	std::deque<std::string> order; /** Pending files, in queue order. */
+	std::unordered_map<std::string, Serializer> pending; /** Last content of the pending files. */
+	bool writing{}; /** A file is being written. */
+	std::string current; /** File being written. */
+	bool stopping{}; /** Stops the worker when the queue is empty. */
+	std::atomic<unsigned> failures{}; /** Failed writes. */
+
+	/**
+	 * @brief Writer thread loop.
+	 * 
+	 */
+	void run();
+};
@@ -10,12 +10,39 @@
 #pragma once
 
 #include <board.h>
+#include <compact-board.h>
 
 #include <list>
+#include <vector>
+
+/**
+ * @brief Search settings of the solver.
+ * 
+ */
+struct SolverOptions {
+	/**
+	 * @brief Rule used to choose the cell to branch on.
+	 * 
+	 */
+	enum class Branching {
+		ROW_MAJOR, /** First empty cell from the top left. */
+		MRV /** Cell with the fewest candidates, ties broken by empty peers. */
+	};
+
+	Branching branching{Branching::MRV}; /** Branching heuristic. */
+	bool propagation{true}; /** Fill the forced cells before each branch. */
+};
 
 /**
  * @brief Solve a Sudoku board with backtracking algorithm.
  * Gets the all solutions.
+ * The candidates of each cell are taken from the digit bitmasks
+ * of its row, column and square, updated when a value is placed
+ * or removed.
+ * Before branching, the forced cells are filled by constraint
+ * propagation: naked singles, hidden singles, locked candidates
+ * (pointing and claiming) and naked and hidden pairs over the rows,
+ * columns and squares.
  * 
  */
 class Solver {
@@ -25,24 +52,212 @@ public:
 	 * 
 	 * @param board Board to solve.
 	 * @param max_solutions maximum of solutions to find. -1 to all.
+	 * @param options search settings.
 	 * @return std::list<Board> list of solutions.
 	 */
-	static std::list<Board> solve(const Board &board, const unsigned max_solutions);
+	static std::list<Board> solve(const Board &board, const unsigned max_solutions,
+			const SolverOptions &options = SolverOptions());
+
+	/**
+	 * @brief Counts the solutions of a Sudoku board without building them.
+	 * 
+	 * @param board Board to solve.
+	 * @param limit stop counting when this number is reached. -1 to all.
+	 * @param options search settings.
+	 * @return const unsigned the number of solutions found.
+	 */
+	static const unsigned count_solutions(const Board &board, const unsigned limit,
+			const SolverOptions &options = SolverOptions());
+
+	/**
+	 * @brief Returns true when the board has exactly one solution.
+	 * The search stops at the second solution.
+	 */
+	static const bool has_unique_solution(const Board &board);
+
+	/**
+	 * @brief Fills the cells forced by the values of the board, without
+	 * branching. The new values are not fixed.
+	 * 
+	 * @param board Board to fill.
+	 * @return false if the board has no solution (the board is not changed).
+	 */
+	static const bool propagate(Board &board);
+
+	/**
+	 * @brief Returns the candidates of each cell: the digits not used in
+	 * its row, column and square. Filled cells have no candidates.
+	 * 
+	 * @param board Board to check (repeated values are allowed).
+	 * @return std::vector<unsigned> a mask per cell, bit (v - 1) for the digit v.
+	 */
+	static std::vector<unsigned> candidate_masks(const Board &board);
+
+	/**
+	 * @brief Counts the solutions of a compact board.
+	 * 
+	 * @param board Board to solve.
+	 * @param limit stop counting when this number is reached. -1 to all.
+	 * @param options search settings.
+	 * @return const unsigned the number of solutions found.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const unsigned count_solutions(const CompactBoard<SW, SH> &board,
+			const unsigned limit, const SolverOptions &options = SolverOptions());
+
+	/**
+	 * @brief Replaces the values of a compact board with its first solution.
+	 * 
+	 * @param board Board to solve.
+	 * @param options search settings.
+	 * @return false if the board has no solution (the board is not changed).
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool solve_first(CompactBoard<SW, SH> &board,
+			const SolverOptions &options = SolverOptions());
 
 private:
+	/**
+	 * @brief Working copy of the board for the search, with the bitmask
+	 * of digits used by each row, column and square.
+	 * Bit (v - 1) is set when the digit v is present.
+	 * 
+	 */
+	template <unsigned SW, unsigned SH>
+	struct State {
+		static constexpr unsigned WIDTH = SW * SH; /** Board width. */
+		static constexpr unsigned SIZE = WIDTH * WIDTH; /** Number of cells. */
+		static constexpr unsigned ALL = (1u << WIDTH) - 1; /** All the digits. */
+
+		CompactBoard<SW, SH> board; /** Cell values. */
+		std::array<unsigned, WIDTH> row_mask{}, col_mask{}, square_mask{}; /** Used digits. */
+		std::array<unsigned, WIDTH> row_empty{}, col_empty{}, square_empty{}; /** Empty cells. */
+		std::array<unsigned, SIZE> eliminated{}; /** Digits removed by locked candidates. */
+
+		/**
+		 * @brief Returns the square index of the cell i.
+		 */
+		static const unsigned square(const unsigned i) {
+			return CompactBoard<SW, SH>::square(i);
+		}
+	};
+
+	/**
+	 * @brief Solve a compact board and return the solutions as copies
+	 * of the given board.
+	 * 
+	 * @param compact Compact copy of board.
+	 * @param board Board to solve, used as model for the solutions.
+	 * @param max_solutions maximum of solutions to find. -1 to all.
+	 * @param options search settings.
+	 * @return std::list<Board> list of solutions.
+	 */
+	template <unsigned SW, unsigned SH>
+	static std::list<Board> solve(const CompactBoard<SW, SH> &compact, const Board &board,
+			const unsigned max_solutions, const SolverOptions &options);
+
+	/**
+	 * @brief Loads the board values into the search state.
+	 * 
+	 * @param board Board to load.
+	 * @param state State to fill.
+	 * @param options search settings.
+	 * @return false if two given values collide or the propagation
+	 * finds no solution.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool load_state(const CompactBoard<SW, SH> &board, State<SW, SH> &state,
+			const SolverOptions &options);
+
+	/**
+	 * @brief Places the value v in the cell i and marks it as used.
+	 */
+	template <unsigned SW, unsigned SH>
+	static void place(State<SW, SH> &state, const unsigned i, const unsigned v);
+
+	/**
+	 * @brief Clears the cell i and releases its value v.
+	 */
+	template <unsigned SW, unsigned SH>
+	static void unplace(State<SW, SH> &state, const unsigned i, const unsigned v);
+
+	/**
+	 * @brief Returns the mask of the digits that fit in the cell i.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const unsigned candidates(const State<SW, SH> &state, const unsigned i);
+
+	/**
+	 * @brief Fills the forced cells until nothing changes.
+	 * 
+	 * @return false if a cell or a unit runs out of candidates.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool propagate(State<SW, SH> &state);
+
+	/**
+	 * @brief Places the naked singles (cells with one candidate) and the
+	 * hidden singles (digits with one cell left in a unit).
+	 * 
+	 * @param state Search state.
+	 * @param changed set to true when a value is placed.
+	 * @return false if a cell or a unit runs out of candidates.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const bool place_singles(State<SW, SH> &state, bool &changed);
+
+	/**
+	 * @brief Removes the locked candidates: a digit confined to one line
+	 * of a square is removed from the rest of the line (pointing), and
+	 * a digit confined to one square of a line is removed from the rest
+	 * of the square (claiming).
+	 * 
+	 * @param state Search state.
+	 * @param changed set to true when a candidate is removed.
+	 */
+	template <unsigned SW, unsigned SH>
+	static void eliminate_locked(State<SW, SH> &state, bool &changed);
+
+	/**
+	 * @brief Removes the candidates ruled out by the pairs of each unit:
+	 * two cells with the same two candidates take them from the rest of
+	 * the unit (naked pair), and two digits with the same two cells left
+	 * take the other candidates from those cells (hidden pair).
+	 * 
+	 * @param state Search state.
+	 * @param changed set to true when a candidate is removed.
+	 */
+	template <unsigned SW, unsigned SH>
+	static void eliminate_pairs(State<SW, SH> &state, bool &changed);
+
 	/**
 	 * @brief Internal solve() function for recursive calls.
 	 * 
-	 * @param board Board to solve.
-	 * @param solutions solutions found.
+	 * @param state Search state.
+	 * @param options search settings.
+	 * @param start first cell that may be empty.
+	 * @param on_solution called with the state of every solution found.
+	 * @param found number of solutions found.
 	 * @param max_solutions maximum of solutions to find. -1 to all.
 	 * @return true if all solutions were found.
 	 */
-	static const bool solve(Board &board, std::list<Board> &solutions, const unsigned max_solutions);
-	
+	template <unsigned SW, unsigned SH, class OnSolution>
+	static const bool solve(State<SW, SH> &state, const SolverOptions &options,
+			const unsigned start, OnSolution &on_solution, unsigned &found,
+			const unsigned max_solutions);
+
 	/**
 	 * @brief Returns the next position with value = 0 on the board
-	 * starting from the top left.
+	 * starting from the given cell.
+	 */
+	template <unsigned SW, unsigned SH>
+	static const unsigned get_next_empty_cell(const State<SW, SH> &state, const unsigned start);
+
+	/**
+	 * @brief Returns the empty cell with the fewest candidates. Ties are
+	 * broken by the number of empty cells sharing its row, column and square.
+	 * Returns the board size when the board is full.
 	 */
-	static const unsigned get_next_empty_cell(const Board &board);
+	template <unsigned SW, unsigned SH>
+	static const unsigned get_mrv_cell(const State<SW, SH> &state);
 };
@@ -12,8 +12,16 @@
 
 #include <gtkmm.h>
 
+#include <future>
+#include <memory>
+
 #include <board.h>
 #include <player.h>
+#include <generator-pool.h>
+#include <puzzle-pool.h>
+#include <collection-index.h>
+#include <save-queue.h>
+#include <move-journal.h>
 
 class MainWindow;
 
@@ -44,21 +52,94 @@ public:
 
 	Player &get_player() { return player; }
 
+	/**
+	 * @brief Get the collection index of the current player.
+	 * The index is loaded (or rebuilt) on the first call and when
+	 * the player changes.
+	 * 
+	 * @return CollectionIndex& collection index.
+	 */
+	CollectionIndex &get_collection();
+
+	/**
+	 * @brief Get the collection index of the current player, maybe not
+	 * loaded yet: CollectionIndex::load() can then run on a worker.
+	 * 
+	 * @return std::shared_ptr<CollectionIndex> collection index.
+	 */
+	std::shared_ptr<CollectionIndex> get_collection_index();
+
+	/**
+	 * @brief Get the background writer of the game files.
+	 * 
+	 * @return SaveQueue& save queue.
+	 */
+	SaveQueue &get_save_queue() { return save_queue; }
+
 	std::shared_ptr<MainWindow> get_main_window() const { return main_window; }
 
 	/**
 	 * @brief Start a new game.
+	 * Takes a pre-generated board from the pool, or generates one in
+	 * background when the pool is empty (the game starts when the board
+	 * is ready).
 	 * @param size game type.
 	 * @param difficulty game difficulty.
 	 */
 	void new_game(const unsigned size, const unsigned difficulty);
 
+	/**
+	 * @brief Returns true while a new board is being generated.
+	 */
+	const bool is_generating() const { return generating.valid(); }
+
 	/**
 	 * @brief Save the current board to the player path.
+	 * The board is written in background: it is cheap enough to call
+	 * after every move.
 	 * 
 	 */
 	void save_board();
 
+	/**
+	 * @brief Sets a value of the current board and records the move
+	 * in the board journal.
+	 */
+	void play(const unsigned x, const unsigned y, const unsigned value);
+
+	/**
+	 * @brief Adds or removes a pencil mark of an empty cell.
+	 */
+	void toggle_note(const unsigned x, const unsigned y, const unsigned value);
+
+	/**
+	 * @brief Replaces the pencil marks with the candidates of every
+	 * empty cell.
+	 */
+	void fill_notes();
+
+	/**
+	 * @brief Reverts the last move of the current board.
+	 * 
+	 * @param x, y set to the cell of the move.
+	 * @return false if there is no move to undo.
+	 */
+	const bool undo(unsigned &x, unsigned &y);
+
+	/**
+	 * @brief Plays again the last undone move of the current board.
+	 * 
+	 * @param x, y set to the cell of the move.
+	 * @return false if there is no move to redo.
+	 */
+	const bool redo(unsigned &x, unsigned &y);
+
+	/**
+	 * @brief Clears the values of the current board and its history.
+	 * 
+	 */
+	void reset_board();
+
 	/**
 	 * @brief Load the current board from the player path.
 	 * 
@@ -94,4 +175,49 @@ private:
 	std::shared_ptr<MainWindow> main_window; /** < Main Window instance. */
 	Board board{}, solved{}; /** < Board object. */
 	Player player;
+
+	Glib::Dispatcher generated_dispatcher; /** < Signals a generated board to the main loop. */
+	std::future<GeneratedBoard> generating; /** < Board being generated. */
+	Glib::Dispatcher solved_dispatcher; /** < Signals the solution of a loaded board to the main loop. */
+	std::future<Board> solving; /** < Solution of the loaded board. */
+	std::unique_ptr<GeneratorPool> generator_pool; /** < Board generator workers. */
+	std::unique_ptr<PuzzlePool> puzzle_pool; /** < Pre-generated boards. */
+	std::shared_ptr<CollectionIndex> collection; /** < Index of the player collection. */
+	SaveQueue save_queue; /** < Background writer, writes the pending files when destroyed. Declared before the journal, which uses it. */
+	MoveJournal journal; /** < Moves of the current board. */
+
+	/**
+	 * @brief Returns the journal file of a board.
+	 */
+	const std::string journal_path(const std::string id);
+
+	/**
+	 * @brief Queues the write of the current board and its index entry.
+	 * 
+	 */
+	void save_snapshot();
+
+	/**
+	 * @brief Queues the write of the collection index.
+	 * 
+	 */
+	void save_collection();
+
+	/**
+	 * @brief Starts the game with the generated board, on the main loop.
+	 * 
+	 */
+	void on_board_generated();
+
+	/**
+	 * @brief Keeps the solution of the loaded board, on the main loop.
+	 * 
+	 */
+	void on_board_solved();
+
+	/**
+	 * @brief Saves and shows the new board.
+	 * 
+	 */
+	void start_game();
 };
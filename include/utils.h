@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <list>
+#include <vector>
 
 #include <cairomm/context.h>
 
@@ -73,11 +74,13 @@ public:
 	 * @param cr Cairo context.
 	 * @param w width of the widget.
 	 * @param h height of the widget.
+	 * @param highlight cells tinted by a hint, by index (empty for none,
+	 * ignored when it does not match the board size).
 	 */
 	static void draw_grid(const Cairo::RefPtr<Cairo::Context>& cr, const Board &board,
 		const unsigned w, const unsigned h,
 		const int sel_x, const int sel_y,
-		const bool error);
+		const bool error, const std::vector<bool> &highlight = {});
 
 	/**
 	 * @brief Check ui object location.
@@ -11,9 +11,19 @@
 
 #include <gtkmm.h>
 
+#include <board.h>
+#include <collection-index.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 class SudokuApp;
-class Board;
 class WelcomeWindow;
+class CollectionView;
 
 /**
  * @brief Collection window for games played.
@@ -34,30 +44,81 @@ public:
 	 * @param parent Parent window.
 	 */
 	static void show(SudokuApp *app, WelcomeWindow *ww);
+
+	/**
+	 * @brief Cancel the board loading.
+	 */
+	~CollectionWindow();
 private:
+	static constexpr unsigned LOAD_BATCH = 32; /** Boards sent to the view at once. */
+
 	SudokuApp *app; /** Application context. */
 	WelcomeWindow *welcomeWindow; /** Parent Welcome Window. */
-	Gtk::FlowBox *board_flow; /** Icon based list to show boards. */
+	CollectionView *collection_view; /** Thumbnails of the boards. */
 	Gtk::Button *play_button, *remove_button; /** Control buttons. */
-	std::vector<Board> board_list; /** Logical board list. */
+	Gtk::ComboBoxText *sort_combo; /** Sort key selector. */
+	std::vector<CollectionEntry> entries; /** Boards of the collection, unsorted. */
+	std::vector<std::string> board_list; /** Logical board list (ids), sorted. */
+
+	std::thread loader; /** Board loading worker. */
+	std::atomic<bool> cancel_loading{}; /** Stops the loading worker. */
+	std::mutex loaded_mutex; /** Guards listed and loaded. */
+	std::vector<CollectionEntry> listed; /** Entries read by the worker, not yet in the list. */
+	std::vector<Board> loaded; /** Boards loaded, not yet in the view. */
+	Glib::Dispatcher loaded_dispatcher; /** Signals loaded boards to the main loop. */
 
 	/**
-	 * @brief Load board list from collection and fills list flow.
+	 * @brief Load board list from collection and fills the view.
+	 * A worker thread loads the collection index (rebuilt when stale),
+	 * then builds the boards, added to the view in batches.
 	 * 
 	 */
 	void load_boards();
 
 	/**
-	 * @brief Sort the board list from most recent to old.
+	 * @brief Worker thread: loads the index and builds the boards in
+	 * the list order.
+	 * 
+	 * @param collection collection index, maybe not loaded yet.
+	 * @param key sort order of the list.
+	 */
+	void run_loader(std::shared_ptr<CollectionIndex> collection, const CollectionSort key);
+
+	/**
+	 * @brief Fills the list with the entries and adds the loaded boards
+	 * to the view, on the main loop.
+	 * 
+	 */
+	void on_boards_loaded();
+
+	/**
+	 * @brief Stops and joins the loading worker.
+	 * 
+	 */
+	void stop_loading();
+
+	/**
+	 * @brief Returns the key selected in the sort combo.
+	 */
+	const CollectionSort get_sort_key() const;
+
+	/**
+	 * @brief Sort the board list by the key selected in the sort combo.
 	 * 
 	 */
 	void sort_boards();
 
+	/**
+	 * @brief Sort combo changed event.
+	 * 
+	 */
+	void sort_changed();
+
 	/**
 	 * @brief Selection change event
 	 * 
 	 */
-	void board_flow_selection_changed();
+	void board_selection_changed();
 
 	/**
 	 * @brief Play button clicked event.
@@ -1,7 +1,7 @@
 /**
  * @file board-area.cpp
  * @author Javier Candales (codigo.mate.9@gmail.com)
- * @brief Implementation of board-view.h
+ * @brief Implementation of board-area.h
  * @date 2024-08-06
  * 
  * @copyright Copyright (c) 2024
@@ -13,6 +13,8 @@
 #include <board.h>
 #include <utils.h>
 
+#include <cctype>
+
 /**
  * @brief Construct a new Board Area object
  */
@@ -49,10 +51,10 @@ bool BoardArea::on_area_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
 
 	auto s_size = double(w <= h ? w : h);
 
-	Utils::draw_grid(cr, app->get_board(), w, h, sel_x, sel_y, error);
+	Utils::draw_grid(cr, app->get_board(), w, h, sel_x, sel_y, error, highlight);
 
 	// Draw "Solved !" if board solved
-	if (app->get_board() == app->get_solved() && !app->get_board().empty()) {
+	if (app->get_board().is_solved()) {
 		cr->set_source_rgb(0, 0, 0);
 		cr->select_font_face("sans", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_BOLD);
 		cr->set_font_size(s_size * 0.18);
@@ -77,13 +79,19 @@ bool BoardArea::on_area_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
  */
 bool BoardArea::on_area_click(GdkEventButton *event) {
 
+	// The typed digit belongs to the cell selected before.
+	play_pending_digit();
+
 	error = false;
+	clear_hint();
 
 	if (event->type == GDK_BUTTON_PRESS && event->button == 1) {
 
+		// Previous selection
+		queue_draw_cells(sel_x, sel_y, sel_x, sel_y);
 		sel_x = sel_y = -1;
 
-		if (app->get_board() == app->get_solved()) return false;
+		if (app->get_board().is_solved()) return false;
 
 		int w = get_allocated_width();
 		int h = get_allocated_height();
@@ -93,10 +101,11 @@ bool BoardArea::on_area_click(GdkEventButton *event) {
 		sel_x = std::floor(double(event->x) / s_size);
 		sel_y = std::floor(double(event->y) / s_size);
 
-		if (sel_x >= 9 || sel_y >= 9)
+		int width = app->get_board().get_width();
+		if (sel_x >= width || sel_y >= width)
 			sel_x = sel_y = -1;
 
-		queue_draw();
+		queue_draw_cells(sel_x, sel_y, sel_x, sel_y);
 
 	}
 
@@ -118,19 +127,46 @@ bool BoardArea::on_area_key_press(GdkEventKey *event) {
 
 	if (event->type == GDK_KEY_PRESS) {
 
-		if (app->get_board() == app->get_solved()) return false;
+		if (app->get_board().is_solved()) return false;
+		clear_hint();
 
 		auto key = gdk_keyval_to_unicode(event->keyval);
+		unsigned width = app->get_board().get_width();
+
+		// Boards wider than 9: two digits typed within a second make a
+		// value ("1" then "6" is 16), and the letters are 10 and up.
+		// A digit that can start a value waits for the second one, so
+		// only the value is played (and journaled).
+		if (pending_digit && key >= '0' && key <= '9' && pending_digit * 10 + key - '0' <= width) {
+			auto value = pending_digit * 10 + key - '0';
+			clear_pending_digit();
+			this->chosen_a_number(value);
+			return true;
+		}
+		play_pending_digit();
+
+		if (width > 9 && key >= '1' && key <= '9' && (key - '0') * 10 <= width) {
+			pending_digit = key - '0';
+			// Tracked slot: disconnected if the area goes away first.
+			pending_timeout = Glib::signal_timeout().connect(
+					sigc::mem_fun(*this, &BoardArea::play_pending_digit), 1000);
+			return true;
+		}
+
 		if (key >= '1' && key <= '9') {
 			this->chosen_a_number(key - '0');
-			queue_draw();
+		}
+
+		if (width > 9 && key < 128 && std::isalpha(key)) {
+			auto value = Board::symbol_value(char(key));
+			if (value <= width) this->chosen_a_number(value);
 		}
 
 		if (key == '0' ||
 				event->keyval == GDK_KEY_BackSpace ||
 				event->keyval == GDK_KEY_Delete) {
-			app->get_board().set(sel_x, sel_y, {unsigned(0), false});
-			queue_draw();
+			app->play(sel_x, sel_y, 0);
+			queue_draw_peers(sel_x, sel_y);
 		}
 
 		return true;
@@ -146,27 +182,175 @@ bool BoardArea::on_area_key_press(GdkEventKey *event) {
  */
 void BoardArea::chosen_a_number(const unsigned number) {
 
+	play_pending_digit();
 	error = false;
 
 	if (sel_x == -1 || sel_y == -1) return;
 	if (app->get_board().get(sel_x, sel_y).fixed) return;
 
-	if (app->get_board() == app->get_solved()) return;
+	if (app->get_board().is_solved()) return;
+	clear_hint();
 
 	auto max = app->get_board().get_width();
 
+	if (notes_mode) {
+		app->toggle_note(sel_x, sel_y, number);
+		queue_draw_cells(sel_x, sel_y, sel_x, sel_y);
+		return;
+	}
+
 	if (number >= 1 && number <= max) {
-		app->get_board().set(sel_x, sel_y, {number, false});
+		app->play(sel_x, sel_y, number);
 
 		if (!app->get_board().is_valid(sel_x, sel_y)) {
 			select(sel_x, sel_y, true); // Select with error
 		}
 
-		// Board solved
-		if (app->get_board() == app->get_solved()) {
+		// Board solved: the banner covers the whole board.
+		if (app->get_board().is_solved()) {
+			queue_draw();
 			app->player_wins();
+			return;
 		}
+
+		queue_draw_peers(sel_x, sel_y);
+		return;
+	}
+
+	queue_draw_cells(sel_x, sel_y, sel_x, sel_y);
+}
+
+/**
+ * @brief Reverts the last move and selects its cell.
+ * 
+ */
+void BoardArea::undo() {
+	play_pending_digit();
+
+	// The game is over once the board is solved.
+	if (app->get_board().is_solved()) return;
+
+	unsigned x, y;
+	if (!app->undo(x, y)) return;
+	clear_hint();
+
+	queue_draw_cells(sel_x, sel_y, sel_x, sel_y);
+	select(x, y, !app->get_board().is_valid(x, y));
+	queue_draw_peers(x, y);
+}
+
+/**
+ * @brief Plays again the last undone move and selects its cell.
+ * 
+ */
+void BoardArea::redo() {
+	play_pending_digit();
+	if (app->get_board().is_solved()) return;
+
+	unsigned x, y;
+	if (!app->redo(x, y)) return;
+	clear_hint();
+
+	queue_draw_cells(sel_x, sel_y, sel_x, sel_y);
+	select(x, y, !app->get_board().is_valid(x, y));
+
+	if (app->get_board().is_solved()) {
+		queue_draw();
+		app->player_wins();
+		return;
 	}
 
+	queue_draw_peers(x, y);
+}
+
+/**
+ * @brief Queues the redraw of the cells from x0, y0 to x1, y1 (included).
+ * Nothing is queued when x0 or y0 is -1 (no cell).
+ */
+void BoardArea::queue_draw_cells(const int x0, const int y0, const int x1, const int y1) {
+	if (x0 < 0 || y0 < 0) return;
+
+	int w = get_allocated_width();
+	int h = get_allocated_height();
+
+	double s_size = double(w <= h ? w : h) / double(app->get_board().get_width());
+
+	// Borders and separators are stroked over the cell edges.
+	int margin = int(std::ceil(s_size * 0.05)) + 1;
+	int left = int(std::floor(x0 * s_size)) - margin;
+	int top = int(std::floor(y0 * s_size)) - margin;
+	int right = int(std::ceil((x1 + 1) * s_size)) + margin;
+	int bottom = int(std::ceil((y1 + 1) * s_size)) + margin;
+
+	queue_draw_area(left, top, right - left, bottom - top);
+}
+
+/**
+ * @brief Queues the redraw of the row, column and square of a cell:
+ * a new value can change the repeated values in all of them.
+ */
+void BoardArea::queue_draw_peers(const int x, const int y) {
+	if (x < 0 || y < 0) return;
+
+	auto &board = app->get_board();
+	int width = board.get_width(), sw = board.get_sw(), sh = board.get_sh();
+
+	queue_draw_cells(0, y, width - 1, y);
+	queue_draw_cells(x, 0, x, width - 1);
+	queue_draw_cells(x / sw * sw, y / sh * sh, x / sw * sw + sw - 1, y / sh * sh + sh - 1);
+}
+
+/**
+ * @brief Selects the cell of a hint and highlights the cells that
+ * explain it, until the next click or move.
+ * 
+ * @param x x coord of the hint cell.
+ * @param y y coord of the hint cell.
+ * @param error true if the hint cell holds a wrong value.
+ * @param cells indexes (y * width + x) of the cells to highlight.
+ */
+void BoardArea::show_hint(const int x, const int y, const bool error,
+		const std::vector<unsigned> &cells) {
+	play_pending_digit();
+	auto width = app->get_board().get_width();
+
+	highlight.assign(width * width, false);
+	for (auto i : cells) highlight[i] = true;
+
+	select(x, y, error);
+	grab_focus();
 	queue_draw();
 }
+
+/**
+ * @brief Removes the highlight of the last hint.
+ */
+void BoardArea::clear_hint() {
+	if (highlight.empty()) return;
+
+	highlight.clear();
+	queue_draw();
+}
+
+/**
+ * @brief Forgets a digit typed as the first of a two digit value,
+ * without playing it (the board changed).
+ */
+void BoardArea::clear_pending_digit() {
+	pending_timeout.disconnect();
+	pending_digit = 0;
+}
+
+/**
+ * @brief Plays the digit typed as the first of a two digit value on
+ * its own: no second digit came within a second, or another action
+ * came first.
+ * 
+ * @return false ever, to stop the timeout.
+ */
+bool BoardArea::play_pending_digit() {
+	auto digit = pending_digit;
+	clear_pending_digit();
+	if (digit) this->chosen_a_number(digit);
+	return false;
+}
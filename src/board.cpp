@@ -9,30 +9,45 @@
  */
 #include <board.h>
 
+#include <generator.h>
+#include <save-queue.h>
+
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <cmath>
+#include <fstream>
+#include <iterator>
+#include <sstream>
 
 #include <libxml/parser.h>
 #include <libxml/tree.h>
-#include <assert.h>
 
 using std::cout;
 using std::endl;
 
+/**
+ * @brief First bytes of the binary board files.
+ * 
+ */
+static const std::string binary_magic = Board::BINARY_MAGIC;
+
 void Board::print() const {
+	// Separator between the squares: two dashes per column, a dot per square.
+	std::string separator = " ";
+	for (unsigned x = 0; x < this->get_width(); x ++) {
+		if (x && x % sw == 0) separator += "·";
+		separator += "--";
+	}
+
 	for (unsigned y = 0; y < this->get_width(); y ++) {
-		if (this->get_size() == 81) {
-			if (y % sh == 0) cout << (y == 0 ? "" : " ------·------·-----") << endl;
-		} else if (this->get_size() == 16) {
-			if (y % sh == 0) cout << (y == 0 ? "" : " ----·----") << endl;
-		}
+		if (y && y % sh == 0) cout << separator << endl;
 
 		for (unsigned x = 0; x < this->get_width(); x ++) {
 			if (x % sw == 0) cout << (x == 0 ? " " : "|");
 
 			if (get(x, y).value)
-				cout << get(x, y).value << " ";
+				cout << symbol(get(x, y).value) << " ";
 			else cout << "  ";
 		}
 		cout << endl;
@@ -41,6 +56,29 @@ void Board::print() const {
 	cout << "Board id: " << id << endl;
 }
 
+/**
+ * @brief Reads the values of an xml board text: numbers or symbols
+ * separated by spaces. A run of digits on a board up to 9x9 is a
+ * value per digit (hand written boards).
+ * 
+ * @param text element text.
+ * @param width board width.
+ * @return std::vector<unsigned> the values in reading order.
+ */
+static std::vector<unsigned> parse_values(const std::string &text, const unsigned width) {
+	std::vector<unsigned> values;
+	std::istringstream in(text);
+	std::string token;
+	while (in >> token) {
+		if (width <= 9 || !std::isdigit((unsigned char)token[0])) {
+			for (auto c : token) if (std::isalnum((unsigned char)c)) values.push_back(Board::symbol_value(c));
+		} else {
+			values.push_back(unsigned(std::atoi(token.c_str())));
+		}
+	}
+	return values;
+}
+
 /**
  * @brief Construct a new Board object
  * Generates an identificator number to persist the board.
@@ -61,7 +99,8 @@ Board::Board(const unsigned size) {
 	// Generate id:
 	auto now = std::chrono::system_clock::now();
 	std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-	std::tm* now_tm = std::localtime(&now_c);
+	std::tm now_buf;
+	std::tm* now_tm = localtime_r(&now_c, &now_buf); // Thread safe: boards are built by workers
 
 	id = std::to_string(now_tm->tm_year + 1900);
 	auto month = now_tm->tm_mon + 1;
@@ -90,6 +129,10 @@ Board::Board(const Board &board) {
 	this->width = board.width;
 	this->sw = board.sw; this->sh = board.sh;
 	for (unsigned i = 0; i < this->board.size(); i ++) this->board[i] = board.board[i];
+	this->counts = board.counts;
+	this->conflicts = board.conflicts;
+	this->filled = board.filled;
+	this->notes = board.notes;
 }
 
 /**
@@ -111,62 +154,93 @@ const Cell Board::get(const unsigned x, const unsigned y) const {
  * @param cell The cell to set.
  */
 void Board::set(const unsigned x, const unsigned y, const Cell cell) {
-	board[y * width + x] = cell;
+	auto &current = board[y * width + x];
+	if (current.value != cell.value) {
+		if (current.value) count_value(x, y, current.value, false);
+		if (cell.value) count_value(x, y, cell.value, true);
+	}
+	current = cell;
 }
 
 /**
- * @brief Checks if a board position (x, y) is valid, meaning its value does not repeat
- * horizontally, vertically, or in the 3x3 area.
- * 
- * @param x X coordinate of the value.
- * @param y Y coordinate of the value.
- * @return true if the value fits.
- * @return false if the value does not fit.
+ * @brief Removes the note of the digit v from the row, column and
+ * square of the cell xy (after placing v in it).
  */
-const bool Board::is_valid(const unsigned x, const unsigned y) const {
+void Board::prune_notes(const unsigned x, const unsigned y, const unsigned v) {
+	if (!v || v > width) return;
+	const unsigned keep = ~(1u << (v - 1));
 
-	auto value = get(x, y).value;
+	// Rows of the notes are contiguous: plain loops the compiler vectorizes.
+	auto row = notes.data() + y * width;
+	for (unsigned i = 0; i < width; i ++) row[i] &= keep;
 
-	for (unsigned xx = 0; xx < width; xx ++) {
-		if (xx == x) continue;
-		if (get(xx, y).value == 0) continue;
-		if (get(xx, y).value == value) return false;
-	}
+	for (unsigned i = 0; i < width; i ++) notes[i * width + x] &= keep;
 
-	for (unsigned yy = 0; yy < width; yy ++) {
-		if (yy == y) continue;
-		if (get(x, yy).value == 0) continue;
-		if (get(x, yy).value == value) return false;
+	auto x0 = x / sw * sw, y0 = y / sh * sh;
+	for (unsigned j = y0; j < y0 + sh; j ++) {
+		auto line = notes.data() + j * width + x0;
+		for (unsigned i = 0; i < sw; i ++) line[i] &= keep;
 	}
+}
 
-	for (unsigned yy = (y / sh) * sh; yy < (y / sh) * sh + sh; yy ++) {
-		for (unsigned xx = (x / sw) * sw; xx < (x / sw) * sw + sw; xx ++) {
-			if (yy == y && xx == x) continue;
-			if (get(xx, yy).value == 0) continue;
-			if (get(xx, yy).value == value) return false;
-		}
-	}
+/**
+ * @brief Removes all the pencil marks.
+ */
+void Board::clear_notes() {
+	std::fill(notes.begin(), notes.end(), 0);
+}
 
-	return true;
+/**
+ * @brief Returns true when a cell has pencil marks.
+ */
+const bool Board::has_notes() const {
+	return std::any_of(notes.begin(), notes.end(), [](const unsigned n) { return n != 0; });
 }
 
 /**
- * @brief Returns true when the board is full.
+ * @brief Adds or removes the value v of the cell xy to the counters.
  * 
- * @return true if the board is full.
- * @return false if the board is not full.
+ * @param add true to add the value, false to remove it.
  */
-const bool Board::full() const {
-	for (signed i = get_size() - 1; i >= 0; i --) if (board[i].value == 0) return false;
-	return true;
+void Board::count_value(const unsigned x, const unsigned y, const unsigned v, const bool add) {
+	for (auto u : {y, width + x, 2 * width + square(x, y)}) {
+		auto &c = count(u, v);
+		if (add) {
+			if (c ++) conflicts ++;
+		} else {
+			if (-- c) conflicts --;
+		}
+	}
+	if (add) filled ++;
+	else filled --;
 }
 
 /**
- * @brief Returns true when the board is clear.
+ * @brief Rebuilds the counters from the cells.
  */
-const bool Board::empty() const {
-	for (unsigned i = 0; i < get_size(); i ++) if (board[i].value) return false;
-	return true;
+void Board::recount() {
+	counts.assign(3 * width * (width + 1), 0);
+	conflicts = filled = 0;
+	for (unsigned i = 0; i < get_size(); i ++) {
+		if (board[i].value) count_value(i % width, i / width, board[i].value, true);
+	}
+}
+
+/**
+ * @brief Checks if a board position (x, y) is valid, meaning its value does not repeat
+ * horizontally, vertically, or in the 3x3 area.
+ * 
+ * @param x X coordinate of the value.
+ * @param y Y coordinate of the value.
+ * @return true if the value fits.
+ * @return false if the value does not fit.
+ */
+const bool Board::is_valid(const unsigned x, const unsigned y) const {
+	auto value = get(x, y).value;
+	if (!value) return true;
+
+	return count(y, value) == 1 && count(width + x, value) == 1 &&
+			count(2 * width + square(x, y), value) == 1;
 }
 
 /**
@@ -200,31 +274,66 @@ const bool Board::operator!=(const Board &board) const {
  */
 void Board::reset() {
 	for (unsigned i = 0; i < get_size(); i ++) if (!board[i].fixed) board[i].value = 0;
+	clear_notes();
 	solved_mark = false;
+	recount();
 }
 
 /**
- * @brief Loads the board from an xml file.
+ * @brief Loads the board from a file, xml or binary (detected
+ * from the first bytes).
  * 
  * @param path Path of the file.
+ * @return false if the file cannot be read (the board is not changed).
  */
-void Board::load(const std::string path) {
-	LIBXML_TEST_VERSION
-
+const bool Board::load(const std::string path) {
 	std::cout << "Loading board: " << path << "." << std::endl;
 
-	auto doc = xmlReadFile(path.c_str(), "UTF-8", 0);
-	assert(doc != nullptr && "Sudoku board: Cannot read xml file.");
+	std::ifstream file(path, std::ios::binary);
+	std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	// Decoded on a copy: a bad file leaves the board as it was.
+	Board loaded = *this;
+	auto ok = file.is_open() && (data.compare(0, binary_magic.size(), binary_magic) == 0 ?
+			loaded.load_binary(data) : loaded.load_xml(data));
+	if (!ok) {
+		std::cerr << "Error: cannot read board file: " << path << "." << std::endl;
+		return false;
+	}
+
+	loaded.recount();
+	*this = loaded;
+	return true;
+}
+
+/**
+ * @brief Decodes an xml board document.
+ * 
+ * @param data file content.
+ * @return false if the document cannot be parsed.
+ */
+const bool Board::load_xml(const std::string &data) {
+	LIBXML_TEST_VERSION
+
+	auto doc = xmlReadMemory(data.c_str(), data.size(), nullptr, "UTF-8", 0);
+	if (doc == nullptr) return false;
 
 	auto root_node = xmlDocGetRootElement(doc);
 
-	this->id = std::string((char *)xmlGetProp(root_node, BAD_CAST "id"));
+	// Missing properties (hand written boards) are left empty
+	auto sid = (char *)xmlGetProp(root_node, BAD_CAST "id");
+	this->id = sid ? std::string(sid) : "";
 	auto ssize = (char *)xmlGetProp(root_node, BAD_CAST "size");
 	unsigned s = 81; // Default value if property not found (prev. versions)
 	if (ssize) s = std::atoi(ssize);
+	if (!is_supported_size(s)) {
+		xmlFreeDoc(doc);
+		return false;
+	}
 	this->board = std::vector<Cell>(s);
 	this->configure_sizes();
-	this->difficulty = std::string((char *)xmlGetProp(root_node, BAD_CAST "difficulty"));
+	auto sdifficulty = (char *)xmlGetProp(root_node, BAD_CAST "difficulty");
+	this->difficulty = sdifficulty ? std::string(sdifficulty) : "";
 	this->solved_mark = xmlStrcmp(xmlGetProp(root_node, BAD_CAST "solved"), BAD_CAST "true") == 0;
 
 	xmlNode *cur_node = nullptr;
@@ -232,37 +341,55 @@ void Board::load(const std::string path) {
 	for (cur_node = root_node->children; cur_node; cur_node = cur_node->next) {
 		if (cur_node->type == XML_ELEMENT_NODE) {
 			if (xmlStrcmp(cur_node->name, BAD_CAST "solved") == 0) {
-				std::string data = (char *) xmlNodeGetContent(cur_node);
-				unsigned index = 0;
-				for (unsigned i = 0; i < data.size() ; i ++) {
-					if (std::isdigit(data[i])) {
-						board[index].value = data[i] - '0';
-						index ++;
-					}
-				}
+				auto values = parse_values((char *) xmlNodeGetContent(cur_node), width);
+				for (unsigned index = 0; index < values.size() && index < board.size(); index ++)
+					board[index].value = values[index] <= width ? values[index] : 0;
+			} else if (xmlStrcmp(cur_node->name, BAD_CAST "notes") == 0) {
+				std::istringstream text((char *) xmlNodeGetContent(cur_node));
+				unsigned mask;
+				for (unsigned index = 0; index < notes.size() && text >> mask; index ++)
+					notes[index] = mask;
 			}
 		} else if (cur_node->type == XML_TEXT_NODE) {
-			std::string data = (char *) cur_node->content;
-
-			unsigned index = 0;
-			for (unsigned i = 0; i < data.size() ; i ++) {
-				if (std::isdigit(data[i])) {
-					board[index].value = data[i] - '0';
-					board[index].fixed = board[index].value ? true : false; 
-					index ++;
-				}
+			auto values = parse_values((char *) cur_node->content, width);
+			for (unsigned index = 0; index < values.size() && index < board.size(); index ++) {
+				board[index].value = values[index] <= width ? values[index] : 0;
+				board[index].fixed = board[index].value ? true : false;
 			}
 		}
 	}
-	
+
+	xmlFreeDoc(doc);
+	return true;
 }
 
 /**
- * @brief Saves the board to an xml file.
+ * @brief Saves the board to a file. The file is replaced at once
+ * (temporary file, fsync and rename).
  * 
  * @param path Path of the file.
+ * @param format file format.
+ * @return false if the file cannot be written.
  */
-void Board::save(const std::string path) {
+const bool Board::save(const std::string path, const Format format) const {
+	std::cout << "Saving board: " << path << "." << std::endl;
+
+	return SaveQueue::write_file(path, serialize(format));
+}
+
+/**
+ * @brief Returns the content of the board file.
+ * 
+ * @param format file format.
+ */
+const std::string Board::serialize(const Format format) const {
+	return format == Format::BINARY ? to_binary() : to_xml();
+}
+
+/**
+ * @brief Returns the board as an xml document.
+ */
+const std::string Board::to_xml() const {
 	LIBXML_TEST_VERSION
 
 	 // Crear un nuevo documento XML
@@ -301,13 +428,163 @@ void Board::save(const std::string path) {
 
 	xmlNodeSetContent(solved, BAD_CAST data.c_str());
 
-	std::cout << "Saving board: " << path << "." << std::endl;
-	auto result = xmlSaveFormatFileEnc(path.c_str(), doc, "UTF-8", 1);
+	// Pencil marks: a mask per cell, bit (v - 1) for the digit v.
+	if (has_notes()) {
+		auto marks = xmlNewNode(nullptr, BAD_CAST "notes");
+		xmlAddChild(root_node, marks);
+
+		data = "\n\t";
+		for (unsigned y = 0; y < width; y ++) {
+			for (unsigned x = 0; x < width; x ++) {
+				data += std::to_string(get_notes(x, y)) + " ";
+			}
+			data += "\n\t";
+		}
+
+		xmlNodeSetContent(marks, BAD_CAST data.c_str());
+	}
 
-	assert(result != -1 && "Sudoku board: Cannot save xml file.");
+	xmlChar *buffer = nullptr;
+	int length = 0;
+	xmlDocDumpFormatMemoryEnc(doc, &buffer, &length, "UTF-8", 1);
+	std::string xml = buffer ? std::string((char *)buffer, length) : "";
 
+	xmlFree(buffer);
 	xmlFreeDoc(doc);
-	xmlCleanupParser();
+
+	return xml;
+}
+
+/**
+ * @brief Returns the bits needed to store the values of a board width.
+ */
+static const unsigned value_bits(const unsigned width) {
+	unsigned bits = 1;
+	while ((1u << bits) <= width) bits ++;
+	return bits;
+}
+
+/**
+ * @brief Reads the field i of a bit array of fields of a number of bits.
+ */
+static const unsigned unpack_bits(const unsigned char *data, const unsigned i, const unsigned bits) {
+	unsigned field = 0;
+	for (unsigned b = 0; b < bits; b ++) {
+		auto bit = i * bits + b;
+		field |= ((data[bit / 8] >> (bit % 8)) & 1u) << b;
+	}
+	return field;
+}
+
+/**
+ * @brief Writes the field i of a bit array of fields of a number of bits.
+ */
+static void pack_bits(std::string &data, const unsigned i, const unsigned bits, const unsigned field) {
+	for (unsigned b = 0; b < bits; b ++) {
+		auto bit = i * bits + b;
+		if ((field >> b) & 1) data[bit / 8] |= 1 << (bit % 8);
+	}
+}
+
+/**
+ * @brief Returns the binary code of a difficulty name: 0 for none,
+ * 1-3 for Easy to Hard, 255 for other names.
+ */
+static const unsigned char difficulty_code(const std::string difficulty) {
+	if (difficulty.empty()) return 0;
+	for (unsigned d = 0; d < 3; d ++)
+		if (difficulty == Generator::difficulty_name(d)) return d + 1;
+	return 255;
+}
+
+/**
+ * @brief Decodes a binary board record.
+ * 
+ * @param data file content.
+ * @return false if the record is truncated or has another version.
+ */
+const bool Board::load_binary(const std::string &data) {
+	unsigned pos = binary_magic.size();
+	auto byte = [&]() -> unsigned { return pos < data.size() ? (unsigned char)data[pos ++] : 0; };
+	auto text = [&](std::string &str) {
+		auto len = byte();
+		str = pos + len <= data.size() ? data.substr(pos, len) : "";
+		pos += len;
+	};
+
+	auto version = byte();
+	if (version < 1 || version > BINARY_VERSION) return false;
+
+	unsigned size = byte();
+	size |= byte() << 8;
+	auto code = byte();
+	auto flags = byte();
+	std::string name;
+	if (code == 255) text(name);
+	else if (code >= 1 && code <= 3) name = Generator::difficulty_name(code - 1);
+	std::string sid;
+	text(sid);
+
+	if (!is_supported_size(size)) return false;
+	unsigned width = std::sqrt(size);
+
+	auto bits = value_bits(width);
+	auto fixed_bytes = (size + 7) / 8;
+	auto value_bytes = (size * bits + 7) / 8;
+	auto note_bytes = flags & 2 ? (size * width + 7) / 8 : 0;
+	if (pos + fixed_bytes + value_bytes + note_bytes > data.size()) return false;
+
+	this->board = std::vector<Cell>(size);
+	this->configure_sizes();
+	this->id = sid;
+	this->difficulty = name;
+	this->solved_mark = flags & 1;
+
+	auto fixed = (const unsigned char *)data.data() + pos;
+	auto values = fixed + fixed_bytes;
+	auto marks = values + value_bytes;
+	for (unsigned i = 0; i < size; i ++) {
+		auto value = unpack_bits(values, i, bits);
+		board[i].value = value <= width ? value : 0;
+		board[i].fixed = board[i].value && (fixed[i / 8] >> (i % 8)) & 1;
+		if (note_bytes) notes[i] = unpack_bits(marks, i, width);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Returns the board as a binary record.
+ */
+const std::string Board::to_binary() const {
+	auto size = get_size();
+	auto bits = value_bits(width);
+	auto code = difficulty_code(difficulty);
+
+	std::string data = binary_magic;
+	data += char(BINARY_VERSION);
+	data += char(size & 0xff);
+	data += char(size >> 8);
+	data += char(code);
+	auto with_notes = has_notes();
+	data += char((solved_mark ? 1 : 0) | (with_notes ? 2 : 0));
+	if (code == 255) {
+		data += char(std::min<std::size_t>(difficulty.size(), 255));
+		data += difficulty.substr(0, 255);
+	}
+	data += char(std::min<std::size_t>(id.size(), 255));
+	data += id.substr(0, 255);
+
+	std::string fixed((size + 7) / 8, 0), values((size * bits + 7) / 8, 0);
+	std::string marks(with_notes ? (size * width + 7) / 8 : 0, 0);
+	for (unsigned i = 0; i < size; i ++) {
+		if (board[i].fixed) fixed[i / 8] |= 1 << (i % 8);
+		pack_bits(values, i, bits, board[i].value);
+		if (with_notes) pack_bits(marks, i, width, notes[i]);
+	}
+	data += fixed + values + marks;
+
+	return data;
 }
 
 /**
@@ -325,8 +602,39 @@ const std::string Board::get_name() const {
 */
 void Board::configure_sizes() {
 	width = unsigned(std::sqrt(get_size()));
-	sw = sh = 3;
-	if (get_size() == 16) {
-		sw = sh = 2;
-	}
+	// The highest divisor of the width up to its square root.
+	sh = unsigned(std::sqrt(width));
+	while (sh > 1 && width % sh) sh --;
+	sw = width / sh;
+	notes.assign(get_size(), 0);
+	recount();
+}
+
+/**
+ * @brief Returns true when a board size (number of cells) can be
+ * played and solved: 4x4, 6x6, 9x9, 16x16 or 25x25.
+ */
+const bool Board::is_supported_size(const unsigned size) {
+	for (unsigned supported : {16u, 36u, 81u, 256u, 625u})
+		if (size == supported) return true;
+	return false;
+}
+
+/**
+ * @brief Returns the character of a value in the texts with a
+ * character per cell: '0' to '9', then 'A' (10) to 'P' (25).
+ */
+const char Board::symbol(const unsigned value) {
+	return value < 10 ? char('0' + value) : char('A' + value - 10);
+}
+
+/**
+ * @brief Returns the value of a character of symbol(), upper or
+ * lower case. Unknown characters are returned as 0 (empty cell).
+ */
+const unsigned Board::symbol_value(const char symbol) {
+	if (symbol >= '0' && symbol <= '9') return symbol - '0';
+	if (symbol >= 'A' && symbol <= 'Z') return symbol - 'A' + 10;
+	if (symbol >= 'a' && symbol <= 'z') return symbol - 'a' + 10;
+	return 0;
 }
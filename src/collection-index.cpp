@@ -0,0 +1,292 @@
+/**
+ * @file collection-index.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of collection-index.h
+ * @date 2024-10-02
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <collection-index.h>
+
+#include <generator.h>
+#include <save-queue.h>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+/**
+ * @brief First line of the index files.
+ * 
+ */
+static const std::string index_header = "sudoku-collection-index 1";
+
+/**
+ * @brief Returns the modification time of a path in nanoseconds,
+ * 0 if it does not exist.
+ */
+static long long modified_ns(const std::string path) {
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0) return 0;
+	return info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+}
+
+/**
+ * @brief Builds the summary of a board.
+ */
+CollectionEntry CollectionEntry::from_board(const Board &board) {
+	CollectionEntry entry;
+	entry.id = board.get_id();
+	entry.size = board.get_size();
+	entry.difficulty = board.get_difficulty();
+	entry.solved = board.is_solved_mark();
+	entry.played = std::time(nullptr);
+
+	auto w = board.get_width();
+	for (unsigned i = 0; i < board.get_size(); i ++) {
+		auto cell = board.get(i % w, i / w);
+		entry.givens += Board::symbol(cell.fixed ? cell.value : 0);
+		entry.values += Board::symbol(cell.value);
+	}
+
+	return entry;
+}
+
+/**
+ * @brief Builds the board of the summary, without reading its file.
+ */
+Board CollectionEntry::to_board() const {
+	Board board(size);
+	board.set_id(id);
+	board.set_difficulty(difficulty);
+	if (solved) board.set_solved_mark(true);
+
+	auto w = board.get_width();
+	for (unsigned i = 0; i < size && i < values.size() && i < givens.size(); i ++)
+		board.set(i % w, i / w, {Board::symbol_value(values[i]), givens[i] != '0'});
+
+	return board;
+}
+
+/**
+ * @brief Returns the file of a board: the binary file (<id>.board),
+ * or the xml file of older versions (<id>.xml) when only that exists.
+ */
+const std::string CollectionIndex::get_board_file(const std::string id) const {
+	auto binary = get_collection_path() + id + ".board";
+	auto xml = get_collection_path() + id + ".xml";
+	return !modified_ns(binary) && modified_ns(xml) ? xml : binary;
+}
+
+/**
+ * @brief Reads the index, rebuilding it when it is missing or stale.
+ * Only the first call reads it; calls from other threads meanwhile
+ * wait for it.
+ */
+void CollectionIndex::load() {
+	std::lock_guard<std::mutex> lock(load_mutex);
+	if (loaded) return;
+
+	if (is_stale() || !read()) rebuild();
+	loaded = true;
+}
+
+/**
+ * @brief Rebuilds the index reading every board file.
+ */
+void CollectionIndex::rebuild() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::cout << "Rebuilding collection index: " << get_index_path() << "." << std::endl;
+
+	entries.clear();
+
+	auto dir = opendir(get_collection_path().c_str());
+	if (dir) {
+		struct dirent *item;
+		while ((item = readdir(dir)) != nullptr) {
+			// Board files: <id>.board, or <id>.xml from older versions
+			std::string file = item->d_name;
+			auto dot = file.rfind('.');
+			if (dot == std::string::npos || dot == 0) continue;
+			auto id = file.substr(0, dot);
+			auto ext = file.substr(dot);
+			if (ext != ".board" && ext != ".xml") continue;
+			if (get_board_file(id) != get_collection_path() + file) continue;
+
+			// Unreadable files are left out of the index.
+			Board board;
+			if (!board.load(get_collection_path() + file)) continue;
+			if (board.get_id().empty()) board.set_id(id);
+
+			auto entry = CollectionEntry::from_board(board);
+			entry.played = modified_ns(get_collection_path() + file) / 1000000000LL;
+			entries.push_back(entry);
+		}
+		closedir(dir);
+	}
+
+	if (!SaveQueue::write_file(get_index_path(), serialize_entries()))
+		std::cerr << "Error: cannot write collection index: " << get_index_path() << std::endl;
+}
+
+/**
+ * @brief Returns true when the index file is missing or older than
+ * the collection directory (boards added or removed by others).
+ */
+const bool CollectionIndex::is_stale() const {
+	auto index = modified_ns(get_index_path());
+	return !index || modified_ns(get_collection_path()) > index;
+}
+
+/**
+ * @brief Adds or replaces the entry of a board.
+ */
+void CollectionIndex::update(const Board &board) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto entry = CollectionEntry::from_board(board);
+	auto it = std::find_if(entries.begin(), entries.end(),
+			[&](const CollectionEntry &e) { return e.id == entry.id; });
+	if (it != entries.end()) *it = entry;
+	else entries.push_back(entry);
+}
+
+/**
+ * @brief Removes the entry of a board.
+ */
+void CollectionIndex::remove(const std::string id) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	entries.erase(std::remove_if(entries.begin(), entries.end(),
+			[&](const CollectionEntry &e) { return e.id == id; }), entries.end());
+}
+
+/**
+ * @brief Returns the content of the index file.
+ */
+const std::string CollectionIndex::serialize() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return serialize_entries();
+}
+
+/**
+ * @brief Writes the index file at once (temporary file, fsync and rename).
+ * 
+ * @return false if the file cannot be written.
+ */
+const bool CollectionIndex::save() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return SaveQueue::write_file(get_index_path(), serialize_entries());
+}
+
+/**
+ * @brief Returns the entries.
+ */
+const std::vector<CollectionEntry> CollectionIndex::get_entries() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return entries;
+}
+
+/**
+ * @brief Finds the entry of a board id.
+ * 
+ * @return false if the board is not in the collection.
+ */
+const bool CollectionIndex::find(const std::string id, CollectionEntry &entry) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto &e : entries) {
+		if (e.id != id) continue;
+		entry = e;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Sorts the entries by a key without moving them.
+ * 
+ * @param entries entries to sort.
+ * @param key sort order.
+ * @return std::vector<unsigned> positions of the entries in order.
+ */
+std::vector<unsigned> CollectionIndex::sort(const std::vector<CollectionEntry> &entries,
+		const CollectionSort key) {
+	std::vector<unsigned> order(entries.size());
+	for (unsigned i = 0; i < order.size(); i ++) order[i] = i;
+
+	// Primary key of each entry, computed once: lower goes first.
+	std::vector<long long> rank(entries.size());
+	for (unsigned i = 0; i < entries.size(); i ++) {
+		auto &e = entries[i];
+		switch (key) {
+		case CollectionSort::ID: rank[i] = 0; break;
+		case CollectionSort::DIFFICULTY:
+			rank[i] = 3;
+			for (unsigned d = 0; d < 3; d ++)
+				if (e.difficulty == Generator::difficulty_name(d)) rank[i] = d;
+			break;
+		case CollectionSort::SOLVED: rank[i] = e.solved; break;
+		case CollectionSort::PLAYED: rank[i] = -e.played; break;
+		}
+	}
+
+	// Ties: newest first
+	std::sort(order.begin(), order.end(), [&](const unsigned a, const unsigned b) {
+		if (rank[a] != rank[b]) return rank[a] < rank[b];
+		return entries[a].id > entries[b].id;
+	});
+
+	return order;
+}
+
+/**
+ * @brief Reads the index file.
+ * 
+ * @return false if the file is missing or has another version.
+ */
+const bool CollectionIndex::read() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::ifstream in(get_index_path());
+	std::string line;
+	if (!std::getline(in, line) || line != index_header) return false;
+
+	entries.clear();
+	while (std::getline(in, line)) {
+		if (line.empty()) continue;
+
+		// id size difficulty solved played givens values
+		std::istringstream fields(line);
+		CollectionEntry entry;
+		fields >> entry.id >> entry.size >> entry.difficulty >> entry.solved >> entry.played >>
+				entry.givens >> entry.values;
+		if (!fields || !Board::is_supported_size(entry.size) ||
+				entry.givens.size() != entry.size || entry.values.size() != entry.size)
+			return false;
+
+		if (entry.difficulty == "-") entry.difficulty = "";
+		entries.push_back(entry);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Returns the content of the index file, the mutex locked.
+ */
+const std::string CollectionIndex::serialize_entries() const {
+	std::ostringstream out;
+	out << index_header << '\n';
+	for (auto &e : entries) {
+		out << e.id << ' ' << e.size << ' ' << (e.difficulty.empty() ? "-" : e.difficulty) << ' ' <<
+				e.solved << ' ' << e.played << ' ' << e.givens << ' ' << e.values << '\n';
+	}
+	return out.str();
+}
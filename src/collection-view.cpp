@@ -0,0 +1,288 @@
+/**
+ * @file collection-view.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of collection-view.h
+ * @date 2024-09-30
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <collection-view.h>
+
+#include <utils.h>
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Construct a new CollectionView
+ * 
+ * @param obj base object.
+ * @param builder ui builder (with the "collection-scrollbar").
+ */
+CollectionView::CollectionView(BaseObjectType* obj, Glib::RefPtr<Gtk::Builder> const& builder)
+		: Gtk::DrawingArea(obj) {
+	builder->get_widget("collection-scrollbar", scrollbar);
+	scrollbar->get_adjustment()->signal_value_changed().connect([this]() {
+		queue_draw();
+	});
+
+	signal_draw().connect([this](const Cairo::RefPtr<Cairo::Context>& cr) -> bool {
+		return this->on_area_draw(cr);
+	});
+
+	signal_size_allocate().connect([this](Gtk::Allocation &) {
+		this->update_scroll();
+	});
+
+	add_events(Gdk::BUTTON_PRESS_MASK | Gdk::SCROLL_MASK | Gdk::SMOOTH_SCROLL_MASK);
+
+	signal_button_press_event().connect([this](GdkEventButton *event) -> bool {
+		return this->on_area_click(event);
+	});
+
+	signal_scroll_event().connect([this](GdkEventScroll *event) -> bool {
+		return this->on_area_scroll(event);
+	});
+}
+
+/**
+ * @brief Sets the boards to show, in order. The boards are added
+ * later with add_boards().
+ * 
+ * @param ids board ids.
+ */
+void CollectionView::set_items(const std::vector<std::string> &ids) {
+	this->ids = ids;
+	thumbnails.clear();
+	selected = -1;
+
+	scrollbar->get_adjustment()->set_value(0);
+	update_scroll();
+	queue_draw();
+	selection_changed.emit();
+}
+
+/**
+ * @brief Shows the same boards in another order, keeping the loaded
+ * boards and the selection.
+ * 
+ * @param ids board ids in the new order.
+ */
+void CollectionView::reorder_items(const std::vector<std::string> &ids) {
+	auto current = get_selected();
+
+	this->ids = ids;
+	auto it = std::find(this->ids.begin(), this->ids.end(), current);
+	selected = current.empty() || it == this->ids.end() ? -1 : int(it - this->ids.begin());
+
+	update_scroll();
+	queue_draw();
+}
+
+/**
+ * @brief Adds loaded boards, matched to the tiles by id.
+ * Only the tiles on screen are redrawn.
+ * 
+ * @param boards loaded boards.
+ */
+void CollectionView::add_boards(const std::vector<Board> &boards) {
+	for (auto &board : boards) thumbnails[board.get_id()] = board;
+
+	// Tiles out of the scrolled area are drawn when they are shown.
+	queue_draw();
+}
+
+/**
+ * @brief Removes a board without reloading the others.
+ */
+void CollectionView::remove_item(const std::string &id) {
+	auto it = std::find(ids.begin(), ids.end(), id);
+	if (it == ids.end()) return;
+
+	auto index = int(it - ids.begin());
+	ids.erase(it);
+	thumbnails.erase(id);
+
+	// The selection stays on the same board, none if it was removed.
+	if (selected == index) selected = -1;
+	else if (selected > index) selected --;
+
+	update_scroll();
+	queue_draw();
+	selection_changed.emit();
+}
+
+/**
+ * @brief Returns the id of the selected board, "" when none.
+ */
+const std::string CollectionView::get_selected() const {
+	if (selected < 0 || selected >= int(ids.size())) return "";
+	return ids[selected];
+}
+
+/**
+ * @brief Returns the number of tile columns for the current width.
+ */
+const int CollectionView::get_columns() const {
+	return std::max(1, (get_allocated_width() - SPACING) / (TILE_W + SPACING));
+}
+
+/**
+ * @brief Updates the scroll range with the number of boards and the size.
+ */
+void CollectionView::update_scroll() {
+	auto columns = get_columns();
+	auto rows = (int(ids.size()) + columns - 1) / columns;
+	auto height = double(get_allocated_height());
+
+	auto adjustment = scrollbar->get_adjustment();
+	adjustment->configure(
+		std::min(adjustment->get_value(), std::max(0.0, rows * (TILE_H + SPACING) + SPACING - height)),
+		0, rows * (TILE_H + SPACING) + SPACING,
+		(TILE_H + SPACING) / 4.0, height * 0.9, height
+	);
+}
+
+/**
+ * @brief Returns the board of an index.
+ * 
+ * @return nullptr if the board is not loaded yet.
+ */
+const Board *CollectionView::get_board(const unsigned index) const {
+	auto it = thumbnails.find(ids[index]);
+	return it == thumbnails.end() ? nullptr : &it->second;
+}
+
+/**
+ * @brief On draw: draws the visible tiles.
+ */
+bool CollectionView::on_area_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
+	auto columns = get_columns();
+	auto scroll = scrollbar->get_adjustment()->get_value();
+
+	// Center the columns
+	auto left = (get_allocated_width() - columns * (TILE_W + SPACING) + SPACING) / 2.0;
+
+	double clip_x1, clip_y1, clip_x2, clip_y2;
+	cr->get_clip_extents(clip_x1, clip_y1, clip_x2, clip_y2);
+
+	// Rows inside the clip region
+	auto first = std::max(0, int((scroll + clip_y1 - SPACING) / (TILE_H + SPACING)));
+	auto last = int((scroll + clip_y2) / (TILE_H + SPACING));
+
+	for (int row = first; row <= last; row ++) {
+		for (int column = 0; column < columns; column ++) {
+			auto index = row * columns + column;
+			if (index >= int(ids.size())) return true;
+
+			draw_tile(cr, index, left + column * (TILE_W + SPACING),
+					SPACING + row * (TILE_H + SPACING) - scroll);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Draws the tile of an index at x, y.
+ */
+void CollectionView::draw_tile(const Cairo::RefPtr<Cairo::Context>& cr, const unsigned index,
+		const double x, const double y) {
+	cr->save();
+	cr->translate(x, y);
+
+	if (int(index) == selected) {
+		cr->set_source_rgb(0.75, 0.85, 1.0);
+		cr->rectangle(0, 0, TILE_W, TILE_H);
+		cr->fill();
+	}
+
+	// Placeholder until the board is loaded
+	auto board = get_board(index);
+	if (!board) {
+		cr->set_source_rgb(0.9, 0.9, 0.9);
+		cr->rectangle((TILE_W - THUMB) / 2.0, 5, THUMB, THUMB);
+		cr->fill();
+		cr->restore();
+		return;
+	}
+
+	// Thumbnail
+	cr->save();
+	cr->translate((TILE_W - THUMB) / 2.0, 5);
+	cr->rectangle(0, 0, THUMB, THUMB);
+	cr->clip();
+	Utils::draw_grid(cr, *board, THUMB, THUMB, -1, -1, false);
+	cr->restore();
+
+	// Name
+	Cairo::TextExtents extents;
+	cr->set_source_rgb(0, 0, 0);
+	cr->select_font_face("sans", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_BOLD);
+	cr->set_font_size(13);
+	cr->get_text_extents(board->get_name(), extents);
+	cr->move_to((TILE_W - extents.x_advance) / 2, THUMB + 24);
+	cr->show_text(board->get_name());
+
+	// Difficulty and solved mark
+	std::string info = board->get_difficulty();
+	if (board->is_solved_mark()) info += info.empty() ? "Solved" : " | Solved";
+
+	cr->select_font_face("sans", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_NORMAL);
+	cr->set_font_size(12);
+	cr->get_text_extents(info, extents);
+	cr->move_to((TILE_W - extents.x_advance) / 2, THUMB + 42);
+	if (board->is_solved_mark()) cr->set_source_rgb(0.13, 0.55, 0.13);
+	cr->show_text(info);
+
+	cr->restore();
+}
+
+/**
+ * @brief On click: selects the tile under the pointer.
+ */
+bool CollectionView::on_area_click(GdkEventButton *event) {
+	if (event->type != GDK_BUTTON_PRESS || event->button != 1) return false;
+
+	auto columns = get_columns();
+	auto left = (get_allocated_width() - columns * (TILE_W + SPACING) + SPACING) / 2.0;
+	auto x = event->x - left;
+	auto y = event->y + scrollbar->get_adjustment()->get_value() - SPACING;
+
+	int index = -1;
+	if (x >= 0 && y >= 0) {
+		auto column = int(x / (TILE_W + SPACING));
+		auto row = int(y / (TILE_H + SPACING));
+		// Inside a tile, not in the spacing
+		if (column < columns && x - column * (TILE_W + SPACING) < TILE_W &&
+				y - row * (TILE_H + SPACING) < TILE_H) index = row * columns + column;
+	}
+	if (index >= int(ids.size())) index = -1;
+
+	if (index != selected) {
+		selected = index;
+		queue_draw();
+		selection_changed.emit();
+	}
+
+	return true;
+}
+
+/**
+ * @brief On mouse wheel: scrolls the tiles.
+ */
+bool CollectionView::on_area_scroll(GdkEventScroll *event) {
+	auto adjustment = scrollbar->get_adjustment();
+
+	double delta = 0;
+	if (event->direction == GDK_SCROLL_UP) delta = -1;
+	else if (event->direction == GDK_SCROLL_DOWN) delta = 1;
+	else if (event->direction == GDK_SCROLL_SMOOTH) delta = event->delta_y;
+
+	auto value = adjustment->get_value() + delta * adjustment->get_step_increment();
+	adjustment->set_value(std::clamp(value, adjustment->get_lower(),
+			adjustment->get_upper() - adjustment->get_page_size()));
+
+	return true;
+}
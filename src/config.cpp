@@ -9,9 +9,9 @@
 #include <config.h>
 #include <utils.h>
 #include <player.h>
+#include <save-queue.h>
 #include <libxml/parser.h>
 #include <sys/types.h>
-#include <assert.h>
 
 /**
  * @brief Prepares the configuration.
@@ -83,6 +83,12 @@ const bool Config::load() {
 
 	current_player = std::string((char *)xmlGetProp(root_node, BAD_CAST "current-player"));
 
+	auto workers = (char *)xmlGetProp(root_node, BAD_CAST "generator-workers");
+	if (workers) generator_workers = std::atoi(workers);
+
+	auto watermark = (char *)xmlGetProp(root_node, BAD_CAST "pool-watermark");
+	if (watermark) pool_watermark = std::atoi(watermark);
+
 	if (current_player == "") {
 		auto list = Config::get_player_list();
 		if (list.empty()) std::cout << "Players not found." << std::endl;
@@ -105,6 +111,10 @@ void Config::save() {
 	xmlDocSetRootElement(doc, root_node);
 
 	xmlNewProp(root_node, BAD_CAST "current-player", BAD_CAST current_player.c_str());
+	xmlNewProp(root_node, BAD_CAST "generator-workers",
+			BAD_CAST std::to_string(generator_workers).c_str());
+	xmlNewProp(root_node, BAD_CAST "pool-watermark",
+			BAD_CAST std::to_string(pool_watermark).c_str());
 
 	char *home_path = std::getenv("HOME");
 	if (home_path == nullptr) {
@@ -116,13 +126,19 @@ void Config::save() {
 
 	std::cout << "Saving config: " << config_file << "." << std::endl;
 
-	auto result = xmlSaveFormatFileEnc(config_file.c_str(), doc, "UTF-8", 1);
-
-	assert(result != -1 && "Sudoku configuration: Cannot save xml file.");
+	xmlChar *buffer = nullptr;
+	int length = 0;
+	xmlDocDumpFormatMemoryEnc(doc, &buffer, &length, "UTF-8", 1);
+	std::string xml = buffer ? std::string((char *)buffer, length) : "";
 
+	xmlFree(buffer);
 	xmlFreeDoc(doc);
-	xmlCleanupParser();
+
+	// Small and rare: written at once, without the save queue.
+	SaveQueue::write_file(config_file, xml);
 }
 
 std::string Config::config_path = "";
 std::string Config::current_player = "";
+unsigned Config::generator_workers = 0;
+unsigned Config::pool_watermark = 3;
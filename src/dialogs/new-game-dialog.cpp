@@ -22,6 +22,9 @@ NewGameDialog::NewGameDialog(BaseObjectType *obj, Glib::RefPtr<Gtk::Builder> con
 	builder->get_widget("hard-option", hard_option);
 	builder->get_widget("x81-option", x81_option);
 	builder->get_widget("x16-option", x16_option);
+	builder->get_widget("x36-option", x36_option);
+	builder->get_widget("x256-option", x256_option);
+	builder->get_widget("x625-option", x625_option);
 }
 
 /**
@@ -40,6 +43,9 @@ const unsigned NewGameDialog::get_selected_level() const {
  */
 const unsigned NewGameDialog::get_selected_size() const {
 	if (x81_option->get_active()) return 81;
+	if (x36_option->get_active()) return 36;
+	if (x256_option->get_active()) return 256;
+	if (x625_option->get_active()) return 625;
 	return 16;
 }
 
@@ -0,0 +1,213 @@
+/**
+ * @file dlx-solver.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of dlx-solver.h
+ * @date 2024-09-02
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <dlx-solver.h>
+
+/**
+ * @brief Solve a Sudoku board and return the solutions.
+ * 
+ * @param board Board to solve.
+ * @param max_solutions maximum of solutions to find. -1 to all.
+ * @return std::list<Board> list of solutions.
+ */
+std::list<Board> DlxSolver::solve(const Board &board, const unsigned max_solutions) {
+	std::list<Board> solutions;
+	Matrix matrix;
+	std::vector<unsigned> chosen;
+	unsigned found = 0;
+
+	build(board, matrix);
+	search(matrix, chosen, board, &solutions, found, max_solutions);
+
+	return solutions;
+}
+
+/**
+ * @brief Counts the solutions of a Sudoku board.
+ * 
+ * @param board Board to solve.
+ * @param limit stop counting when this number is reached. -1 to all.
+ * @return const unsigned the number of solutions found.
+ */
+const unsigned DlxSolver::count(const Board &board, const unsigned limit) {
+	Matrix matrix;
+	std::vector<unsigned> chosen;
+	unsigned found = 0;
+
+	build(board, matrix);
+	search(matrix, chosen, board, nullptr, found, limit);
+
+	return found;
+}
+
+/**
+ * @brief Builds the exact cover matrix of the board.
+ * Given cells only get the row of their value and empty cells the
+ * rows of the values not used by the givens of their units.
+ * 
+ * @param board Board to encode.
+ * @param matrix Matrix to fill.
+ */
+void DlxSolver::build(const Board &board, Matrix &matrix) {
+	auto w = board.get_width();
+	auto cells = board.get_size();
+	auto columns = 4 * cells;
+
+	// Digits used by the givens of each unit
+	std::vector<unsigned> rows(w), cols(w), squares(w);
+	auto square_of = [&board, w](const unsigned x, const unsigned y) {
+		return (y / board.get_sh()) * (w / board.get_sw()) + x / board.get_sw();
+	};
+
+	for (unsigned i = 0; i < cells; i ++) {
+		auto v = board.get(i % w, i / w).value;
+		if (!v) continue;
+		rows[i / w] |= 1u << (v - 1);
+		cols[i % w] |= 1u << (v - 1);
+		squares[square_of(i % w, i / w)] |= 1u << (v - 1);
+	}
+
+	matrix.left.clear(); matrix.right.clear();
+	matrix.up.clear(); matrix.down.clear();
+	matrix.column.clear(); matrix.row.clear();
+	matrix.size = std::vector<unsigned>(columns + 1);
+
+	// Root and column headers
+	for (unsigned c = 0; c <= columns; c ++) {
+		matrix.left.push_back(c ? c - 1 : columns);
+		matrix.right.push_back(c < columns ? c + 1 : 0);
+		matrix.up.push_back(c);
+		matrix.down.push_back(c);
+		matrix.column.push_back(c);
+		matrix.row.push_back(0);
+	}
+
+	for (unsigned i = 0; i < cells; i ++) {
+		auto x = i % w, y = i / w, s = square_of(x, y);
+		auto given = board.get(x, y).value;
+
+		for (unsigned v = 1; v <= w; v ++) {
+			if (given) {
+				if (v != given) continue;
+			} else if ((rows[y] | cols[x] | squares[s]) & (1u << (v - 1))) continue;
+
+			unsigned targets[] = {
+				1 + i,
+				1 + cells + y * w + v - 1,
+				1 + 2 * cells + x * w + v - 1,
+				1 + 3 * cells + s * w + v - 1
+			};
+
+			unsigned first = matrix.column.size();
+			for (unsigned k = 0; k < 4; k ++) {
+				auto node = first + k;
+				auto c = targets[k];
+
+				matrix.left.push_back(k ? node - 1 : first + 3);
+				matrix.right.push_back(k < 3 ? node + 1 : first);
+				matrix.up.push_back(matrix.up[c]);
+				matrix.down.push_back(c);
+				matrix.column.push_back(c);
+				matrix.row.push_back(i * w + v - 1);
+
+				matrix.down[matrix.up[c]] = node;
+				matrix.up[c] = node;
+				matrix.size[c] ++;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Removes the column c and all the rows that cover it.
+ */
+void DlxSolver::cover(Matrix &matrix, const unsigned c) {
+	matrix.right[matrix.left[c]] = matrix.right[c];
+	matrix.left[matrix.right[c]] = matrix.left[c];
+
+	for (auto i = matrix.down[c]; i != c; i = matrix.down[i]) {
+		for (auto j = matrix.right[i]; j != i; j = matrix.right[j]) {
+			matrix.down[matrix.up[j]] = matrix.down[j];
+			matrix.up[matrix.down[j]] = matrix.up[j];
+			matrix.size[matrix.column[j]] --;
+		}
+	}
+}
+
+/**
+ * @brief Restores the column c and all the rows that cover it.
+ */
+void DlxSolver::uncover(Matrix &matrix, const unsigned c) {
+	for (auto i = matrix.up[c]; i != c; i = matrix.up[i]) {
+		for (auto j = matrix.left[i]; j != i; j = matrix.left[j]) {
+			matrix.size[matrix.column[j]] ++;
+			matrix.down[matrix.up[j]] = j;
+			matrix.up[matrix.down[j]] = j;
+		}
+	}
+
+	matrix.right[matrix.left[c]] = c;
+	matrix.left[matrix.right[c]] = c;
+}
+
+/**
+ * @brief Internal recursive Algorithm X search.
+ * 
+ * @param matrix Exact cover matrix.
+ * @param chosen Nodes of the rows chosen so far.
+ * @param board Board to solve, used as model for the solutions.
+ * @param solutions solutions found, nullptr to only count them.
+ * @param found number of solutions found.
+ * @param limit maximum of solutions to find. -1 to all.
+ * @return true if all solutions were found.
+ */
+const bool DlxSolver::search(Matrix &matrix, std::vector<unsigned> &chosen,
+		const Board &board, std::list<Board> *solutions, unsigned &found,
+		const unsigned limit) {
+
+	// All columns covered: solution found
+	if (matrix.right[0] == 0) {
+		if (solutions) {
+			auto w = board.get_width();
+			solutions->push_back(board);
+			for (auto node : chosen) {
+				auto i = matrix.row[node] / w;
+				auto cell = board.get(i % w, i / w);
+				cell.value = matrix.row[node] % w + 1;
+				solutions->back().set(i % w, i / w, cell);
+			}
+		}
+
+		found ++;
+		return found == limit;
+	}
+
+	// Column with the fewest rows
+	auto c = matrix.right[0];
+	for (auto j = matrix.right[c]; j != 0; j = matrix.right[j])
+		if (matrix.size[j] < matrix.size[c]) c = j;
+
+	if (matrix.size[c] == 0) return false;
+
+	cover(matrix, c);
+
+	for (auto r = matrix.down[c]; r != c; r = matrix.down[r]) {
+		chosen.push_back(r);
+		for (auto j = matrix.right[r]; j != r; j = matrix.right[j]) cover(matrix, matrix.column[j]);
+
+		if (search(matrix, chosen, board, solutions, found, limit)) return true;
+
+		for (auto j = matrix.left[r]; j != r; j = matrix.left[j]) uncover(matrix, matrix.column[j]);
+		chosen.pop_back();
+	}
+
+	uncover(matrix, c);
+
+	return false;
+}
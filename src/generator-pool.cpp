@@ -0,0 +1,183 @@
+/**
+ * @file generator-pool.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of generator-pool.h
+ * @date 2024-09-10
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <generator-pool.h>
+
+#include <generator.h>
+#include <solver.h>
+
+#include <chrono>
+#include <iostream>
+
+/**
+ * @brief Construct a new GeneratorPool and start its workers.
+ * 
+ * @param workers number of worker threads. 0: one per hardware thread.
+ */
+GeneratorPool::GeneratorPool(const unsigned workers) {
+	auto count = workers ? workers : std::thread::hardware_concurrency();
+	if (!count) count = 1;
+
+	std::cout << "Starting " << count << " generator worker(s)." << std::endl;
+
+	for (unsigned i = 0; i < count; i ++)
+		threads.emplace_back([this]() { this->run_worker(); });
+}
+
+/**
+ * @brief Cancel the pending requests and join the workers.
+ * The futures of the pending requests get an empty board.
+ */
+GeneratorPool::~GeneratorPool() {
+	cancel();
+
+	// The workers drain the queue: the cancelled racers return at once
+	// and the queued solutions are released without solving.
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	condition.notify_all();
+	for (auto &t : threads) t.join();
+}
+
+/**
+ * @brief Request a new board.
+ * 
+ * @param size the size of the board.
+ * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+ * @param ready called from the winning worker thread once the board
+ * is available in the future (can be empty).
+ * @param racers number of seeds raced. 0: one per worker.
+ * @return std::future<GeneratedBoard> the generated board and its solution.
+ */
+std::future<GeneratedBoard> GeneratorPool::generate(const unsigned size, const unsigned difficulty,
+		std::function<void()> ready, const unsigned racers) {
+	auto race = std::make_shared<Race>();
+	race->size = size;
+	race->difficulty = difficulty;
+	race->ready = ready;
+	race->running = racers ? racers : get_workers();
+
+	auto future = race->promise.get_future();
+	auto base_seed = unsigned(std::chrono::system_clock::now().time_since_epoch().count());
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		races.remove_if([](const std::weak_ptr<Race> &r) { return r.expired(); });
+		races.push_back(race);
+
+		for (unsigned i = 0; i < race->running; i ++)
+			tasks.push_back([race, base_seed, i]() { run_racer(race, base_seed + i); });
+	}
+
+	condition.notify_all();
+
+	return future;
+}
+
+/**
+ * @brief Cancel the pending requests: their racers stop and their
+ * futures get an empty board.
+ */
+void GeneratorPool::cancel() {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto &r : races) {
+		auto race = r.lock();
+		if (race && !race->done.exchange(true))
+			race->promise.set_value(GeneratedBoard{Board(race->size), Board(race->size)});
+	}
+	races.clear();
+}
+
+/**
+ * @brief Request the solution of a board, solved on a worker.
+ * 
+ * @param board board to solve, from its fixed values.
+ * @param ready called from the worker thread once the solution is
+ * available in the future.
+ * @return std::future<Board> the solution, an empty board when the
+ * board has none.
+ */
+std::future<Board> GeneratorPool::solve(const Board &board, std::function<void()> ready) {
+	auto promise = std::make_shared<std::promise<Board>>();
+	auto future = promise->get_future();
+
+	auto solving = board;
+	solving.reset();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back([this, promise, solving, ready]() {
+			if (stopping) {
+				promise->set_value(Board(solving.get_size()));
+				return;
+			}
+
+			auto solutions = Solver::solve(solving, 1);
+			promise->set_value(solutions.empty() ? Board(solving.get_size()) : solutions.front());
+			if (ready) ready();
+		});
+	}
+
+	condition.notify_one();
+
+	return future;
+}
+
+/**
+ * @brief Runs one racer of a request on a worker thread.
+ * 
+ * @param race the request.
+ * @param seed random seed of this racer.
+ */
+void GeneratorPool::run_racer(std::shared_ptr<Race> race, const unsigned seed) {
+	if (!race->done) {
+		Generator::seed(seed);
+
+		GeneratedBoard generated;
+		generated.board = Generator::generate_graded(race->size, race->difficulty,
+				&race->done, &generated.solved);
+		generated.board.set_difficulty(Generator::difficulty_name(race->difficulty));
+
+		// First valid board wins
+		if (!generated.board.empty() && !race->done.exchange(true)) {
+			race->promise.set_value(generated);
+			if (race->ready) race->ready();
+		}
+	}
+
+	// Nobody won (cancelled): release the waiting side with an empty board.
+	if (-- race->running == 0 && !race->done.exchange(true)) {
+		race->promise.set_value(GeneratedBoard{Board(race->size), Board(race->size)});
+		if (race->ready) race->ready();
+	}
+}
+
+/**
+ * @brief Worker thread loop.
+ * 
+ */
+void GeneratorPool::run_worker() {
+	for (;;) {
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+			if (tasks.empty()) return; // stopping, nothing left to run
+
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+
+		task();
+	}
+}
@@ -10,19 +10,25 @@
 
 #include <generator.h>
 
+#include <algorithm>
 #include <random>
 #include <chrono>
 #include <iostream>
+#include <thread>
 
 #include <board.h>
 
 #include <solver.h>
+#include <grader.h>
 
 /**
- * @brief Random generator.
+ * @brief Random generator, one per thread.
  * 
  */
-std::default_random_engine rand_generator(std::chrono::system_clock::now().time_since_epoch().count());
+thread_local std::default_random_engine rand_generator(
+	std::chrono::system_clock::now().time_since_epoch().count() ^
+	std::hash<std::thread::id>()(std::this_thread::get_id())
+);
 
 /**
  * @brief Shuffle a vector.
@@ -37,31 +43,148 @@ void shuffle(std::vector<unsigned> &v);
  * @param visible_numbers expected visible values.
  * @param solutions number of solutions of the board.
  * @param size the size of the board.
+ * @param cancel when set to true, the generation stops and returns
+ * an empty board.
  * @return Board the generated board.
  */
 Board Generator::generate_board(const unsigned vn, const unsigned solutions,
-			const unsigned size) {
+			const unsigned size, const std::atomic<bool> *cancel) {
 
-	std::cout << "Randomize board. ";
-	Board board = fill_board(size);
+	Board generated(size);
 
-	std::cout << "id: " << board.get_id() << std::endl;
-
-	std::cout << "Generating id: " << board.get_id() << " (VN: " << vn <<
+	std::cout << "Generating id: " << generated.get_id() << " (VN: " << vn <<
 			", Sol: " << solutions << ")." << std::endl; 
 
-	Board generated;
-	generate_board(board, generated, vn, solutions);
+	visit_compact(generated.get_sw(), generated.get_sh(), [&](auto compact) {
+		using Compact = decltype(compact);
+
+		std::cout << "Randomize board." << std::endl;
+		auto board = fill_board<Compact::SQUARE_W, Compact::SQUARE_H>();
+
+		if (!generate_board(board, compact, vn, solutions, cancel)) {
+			std::cout << "Generation stopped." << std::endl;
+			return;
+		}
+
+		std::cout << "Fixing visible values." << std::endl;
+		// Fix the visible values
+		for (unsigned i = 0; i < compact.SIZE; i ++)
+			compact.set_fixed(i, compact.get(i) != 0);
 
-	std::cout << "Fixing visible values." << std::endl;
-	// Fix the visible values
-	for (unsigned i = 0; i < size; i ++)
-		if (generated.board[i].value) 
-			generated.board[i].fixed = true;
+		compact.store(generated);
+	});
 
 	return generated;
 }
 
+/**
+ * @brief Generates a new Sudoku board rated by the grader at the given
+ * difficulty level, with a single solution.
+ * 
+ * @param size the size of the board.
+ * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+ * @param cancel when set to true, the generation stops and returns
+ * an empty board.
+ * @param solved when not nullptr, receives the solution of the board:
+ * the full board the numbers were removed from.
+ * @return Board the generated board.
+ */
+Board Generator::generate_graded(const unsigned size, const unsigned difficulty,
+			const std::atomic<bool> *cancel, Board *solved) {
+	// Full boards tried before settling for the closest level. Few
+	// small boards rate Hard without guessing, but they are fast to
+	// try; the larger ones reach their level at once.
+	const unsigned attempts = size <= 81 ? 256 : 16;
+
+	Board generated(size);
+	auto vn = visible_numbers(size, difficulty);
+
+	std::cout << "Generating id: " << generated.get_id() << " (" <<
+			difficulty_name(difficulty) << ", VN: " << vn << ")." << std::endl;
+
+	visit_compact(generated.get_sw(), generated.get_sh(), [&](auto compact) {
+		using Compact = decltype(compact);
+
+		unsigned best = 0;
+		Compact solution;
+		for (unsigned attempt = 0; attempt < attempts; attempt ++) {
+			auto full = fill_board<Compact::SQUARE_W, Compact::SQUARE_H>();
+			auto board = full;
+			auto level = remove_graded(board, vn, difficulty, cancel);
+
+			if (cancel && *cancel) {
+				std::cout << "Generation stopped." << std::endl;
+				return;
+			}
+
+			if (!attempt || level > best) {
+				compact = board;
+				solution = full;
+				best = level;
+			}
+			if (level == difficulty) break;
+		}
+
+		// Fix the visible values
+		for (unsigned i = 0; i < compact.SIZE; i ++) {
+			compact.set_fixed(i, compact.get(i) != 0);
+			solution.set_fixed(i, compact.get(i) != 0);
+		}
+
+		compact.store(generated);
+
+		// The board has a single solution: the full board.
+		if (solved) {
+			*solved = generated;
+			solution.store(*solved);
+		}
+	});
+
+	return generated;
+}
+
+/**
+ * @brief Removes numbers from a full board in random order, keeping
+ * the ones that would rate the board above the difficulty level
+ * or make the grader guess.
+ * 
+ * @param board Board to remove numbers from.
+ * @param vn Number of visible numbers to stop at once the level is reached.
+ * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+ * @param cancel stops the removal when set to true (can be nullptr).
+ * @return the difficulty level of the resulting board.
+ */
+template <unsigned SW, unsigned SH>
+const unsigned Generator::remove_graded(CompactBoard<SW, SH> &board, const unsigned vn,
+			const unsigned difficulty, const std::atomic<bool> *cancel) {
+	std::vector<unsigned> positions;
+	for (unsigned i = 0; i < board.SIZE; i ++) positions.push_back(i);
+	shuffle(positions);
+
+	unsigned visible = board.SIZE, level = 0;
+	for (auto p : positions) {
+		if (cancel && *cancel) break;
+
+		auto v = board.get(p);
+		board.set(p, 0);
+
+		// Every level, on every size, is solved by the grader without
+		// guessing: such a board has a single solution, and boards that
+		// need guessing are above Hard.
+		auto grade = Grader::grade(board);
+		auto removed = Grader::difficulty(grade);
+		if (grade.is_solved() && removed <= difficulty) {
+			level = removed;
+			if (-- visible <= vn && level == difficulty) break;
+			continue;
+		}
+
+		board.set(p, v);
+	}
+
+	return level;
+}
+
 /**
  * @brief Internal recursive method to generate a Sudoku board.
  * 
@@ -69,16 +192,19 @@ Board Generator::generate_board(const unsigned vn, const unsigned solutions,
  * @param generated Resulting board.
  * @param vn Number of visible numbers.
  * @param solutions Expected number of solutions.
+ * @param cancel stops the search when set to true (can be nullptr).
  * @return true When a board meeting the conditions is found.
  * @return false The board does not meet the conditions and continues searching.
  */
-const bool Generator::generate_board(Board generating, Board &generated,
-			const unsigned vn, const unsigned solutions) {
+template <unsigned SW, unsigned SH>
+const bool Generator::generate_board(CompactBoard<SW, SH> generating,
+			CompactBoard<SW, SH> &generated, const unsigned vn, const unsigned solutions,
+			const std::atomic<bool> *cancel) {
 	std::vector<unsigned> positions;
 
 	// Load visible positions
-	for (unsigned i = 0; i < generating.get_size(); i ++)
-		if (generating.board[i].value) 
+	for (unsigned i = 0; i < generating.SIZE; i ++)
+		if (generating.get(i)) 
 			positions.push_back(i);
 
 	if (positions.size() <= vn) {
@@ -91,13 +217,14 @@ const bool Generator::generate_board(Board generating, Board &generated,
 	shuffle(positions);
 
 	for (auto p : positions) {
-		auto v = generating.board[p].value;
-		generating.board[p].value = 0;
-		auto sc = Solver::solve(generating, solutions + 1).size();
-		if (sc <= solutions) {
-			if (generate_board(generating, generated, vn, solutions)) return true;
+		if (cancel && *cancel) return false;
+
+		auto v = generating.get(p);
+		generating.set(p, 0);
+		if (Solver::count_solutions(generating, solutions + 1) <= solutions) {
+			if (generate_board(generating, generated, vn, solutions, cancel)) return true;
 		}
-		generating.board[p].value = v;
+		generating.set(p, v);
 		
 	}
 
@@ -116,40 +243,79 @@ const unsigned Generator::hidden_count(const Board &board) {
 /**
  * @brief Generates a new fully board with randomized values.
  * The board is validated with the Sudoku's rules.
- * @param size the size of the board.
- * @return Board The generated board.
+ * @return CompactBoard The generated board.
  */
-Board Generator::fill_board(const unsigned size) {
+template <unsigned SW, unsigned SH>
+CompactBoard<SW, SH> Generator::fill_board() {
 
-	Board board(size);
+	CompactBoard<SW, SH> board;
 
-	auto sz = board.get_width();
-	auto step = board.get_sw();
+	auto sz = board.WIDTH;
 
-	// Squares
-	for (unsigned s = 0; s < sz; s += step) {
+	// Squares on the diagonal: they share no row or column, any
+	// values fit. Rectangular squares have fewer of them.
+	for (unsigned s = 0; s < std::min(SW, SH); s ++) {
 		// Numbers
-		std::vector<unsigned> list = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
-		if (size != 81) list = { 1, 2, 3, 4 };
+		std::vector<unsigned> list;
+		for (unsigned v = 1; v <= sz; v ++) list.push_back(v);
 
 		shuffle(list);
-		for (unsigned y = s; y < s + step; y ++) {
-			for (unsigned x = s; x < s + step; x ++) {
-				board.set(x, y, { list.back(), false });
+		for (unsigned y = s * SH; y < (s + 1) * SH; y ++) {
+			for (unsigned x = s * SW; x < (s + 1) * SW; x ++) {
+				board.set(y * sz + x, list.back());
 				list.pop_back();
 			}
 		}
 	}
 
-
-	auto solutions = Solver::solve(board, 1);
-	
 	// Considere 8x8 boards no solutions recall fill_board()
-	if (solutions.size() == 0) {
-		return fill_board(size);
+	if (!Solver::solve_first(board)) {
+		return fill_board<SW, SH>();
 	}
 
-	return solutions.front();
+	return board;
+}
+
+/**
+ * @brief Returns a random count of visible numbers for a difficulty level.
+ * 
+ * @param size the size of the board.
+ * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+ */
+const unsigned Generator::visible_numbers(const unsigned size, const unsigned difficulty) {
+	if (size == 81 || size == 16) {
+		switch (difficulty) {
+		// Easy
+		case 0: return size == 81 ? rand_int(35, 45) : rand_int(10, 11);
+		// Medium
+		case 1: return size == 81 ? rand_int(30, 34) : rand_int(8, 9);
+		}
+		// Hard
+		return size == 81 ? rand_int(26, 29) : rand_int(5, 7);
+	}
+
+	// Other sizes: percent of the cells, close to the 9x9 counts.
+	int min = 32, max = 36;
+	switch (difficulty) {
+	// Easy
+	case 0: min = 43; max = 55; break;
+	// Medium
+	case 1: min = 37; max = 42; break;
+	}
+	return rand_int(size * min / 100, size * max / 100);
+}
+
+/**
+ * @brief Returns the name of a difficulty level.
+ * 
+ * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+ */
+const std::string Generator::difficulty_name(const unsigned difficulty) {
+	switch (difficulty) {
+	case 0: return "Easy";
+	case 1: return "Medium";
+	}
+	return "Hard";
 }
 
 /**
@@ -160,6 +326,14 @@ const int Generator::rand_int(const int min, const int max) {
 	return dist(rand_generator);
 }
 
+/**
+ * @brief Seeds the random generator of the calling thread.
+ * Each thread has its own random generator.
+ */
+void Generator::seed(const unsigned seed) {
+	rand_generator.seed(seed);
+}
+
 /**
  * @brief Shuffle a vector.
  * 
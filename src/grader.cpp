@@ -0,0 +1,536 @@
+/**
+ * @file grader.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of grader.h
+ * @date 2024-09-24
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <grader.h>
+
+/**
+ * @brief Rates a board.
+ * 
+ * @param board Board to rate.
+ * @param steps when not nullptr, receives the deductions in order.
+ * @return Grade the rating.
+ */
+Grade Grader::grade(const Board &board, std::vector<GradeStep> *steps) {
+	return visit_compact(board.get_sw(), board.get_sh(), [&](auto compact) {
+		return grade(decltype(compact)(board), steps);
+	});
+}
+
+/**
+ * @brief Rates a compact board.
+ * 
+ * @param board Board to rate.
+ * @param steps when not nullptr, receives the deductions in order.
+ * @return Grade the rating.
+ */
+template <unsigned SW, unsigned SH>
+Grade Grader::grade(const CompactBoard<SW, SH> &board, std::vector<GradeStep> *steps) {
+	Grade grade;
+	Grid<SW, SH> grid;
+
+	if (!load_grid(board, grid)) grade.hardest = Technique::GUESS;
+
+	GradeStep step;
+	while (grid.empty && grade.is_solved()) {
+		auto technique = apply(grid, steps ? &step : nullptr);
+		if (technique > grade.hardest) grade.hardest = technique;
+		if (technique == Technique::GUESS) break;
+
+		grade.steps ++;
+		if (steps) {
+			step.technique = technique;
+			steps->push_back(std::move(step));
+			step = GradeStep();
+		}
+	}
+
+	grade.rating = weight(grade.hardest) * 100 + grade.steps;
+	return grade;
+}
+
+/**
+ * @brief Finds the next deduction a person would make on a board:
+ * the easiest techniques are applied until one fills a cell.
+ * 
+ * @param board Board to check, with the values played so far.
+ * @param hint receives the cell and value filled, the hardest
+ * technique needed and the cells of the patterns that lead to it.
+ * @return false if the board is full, has repeated values or needs guessing.
+ */
+const bool Grader::hint(const Board &board, GradeStep &hint) {
+	return visit_compact(board.get_sw(), board.get_sh(), [&](auto compact) {
+		using Compact = decltype(compact);
+		Grid<Compact::SQUARE_W, Compact::SQUARE_H> grid;
+		if (!load_grid(Compact(board), grid)) return false;
+
+		// Eliminations are kept in the hint: they lead to the filled cell.
+		hint = GradeStep();
+		GradeStep step;
+		while (grid.empty) {
+			auto technique = apply(grid, &step);
+			if (technique == Technique::GUESS) return false;
+
+			if (technique > hint.technique) hint.technique = technique;
+			hint.digits |= step.digits;
+			hint.cells.insert(hint.cells.end(), step.cells.begin(), step.cells.end());
+			hint.eliminated.insert(hint.eliminated.end(), step.eliminated.begin(),
+					step.eliminated.end());
+
+			if (step.value) {
+				hint.cell = step.cell;
+				hint.value = step.value;
+				return true;
+			}
+			step = GradeStep();
+		}
+
+		return false;
+	});
+}
+
+/**
+ * @brief Returns the difficulty level of a rating.
+ * 
+ * @return 0: Easy (singles), 1: Medium (up to pairs), 2: Hard (up to
+ * X-wings, or guessing when the board is not solved).
+ */
+const unsigned Grader::difficulty(const Grade &grade) {
+	if (grade.hardest <= Technique::HIDDEN_SINGLE) return 0;
+	if (grade.hardest <= Technique::HIDDEN_PAIR) return 1;
+	return 2;
+}
+
+/**
+ * @brief Returns the weight of a technique in the rating.
+ */
+const unsigned Grader::weight(const Technique technique) {
+	switch (technique) {
+	case Technique::NAKED_SINGLE: return 1;
+	case Technique::HIDDEN_SINGLE: return 2;
+	case Technique::LOCKED_CANDIDATES: return 4;
+	case Technique::NAKED_PAIR: return 6;
+	case Technique::HIDDEN_PAIR: return 8;
+	case Technique::NAKED_TRIPLE: return 10;
+	case Technique::HIDDEN_TRIPLE: return 12;
+	case Technique::X_WING: return 16;
+	case Technique::GUESS: break;
+	}
+	return 30;
+}
+
+/**
+ * @brief Returns the name of a technique.
+ */
+const std::string Grader::technique_name(const Technique technique) {
+	switch (technique) {
+	case Technique::NAKED_SINGLE: return "Naked single";
+	case Technique::HIDDEN_SINGLE: return "Hidden single";
+	case Technique::LOCKED_CANDIDATES: return "Locked candidates";
+	case Technique::NAKED_PAIR: return "Naked pair";
+	case Technique::HIDDEN_PAIR: return "Hidden pair";
+	case Technique::NAKED_TRIPLE: return "Naked triple";
+	case Technique::HIDDEN_TRIPLE: return "Hidden triple";
+	case Technique::X_WING: return "X-Wing";
+	case Technique::GUESS: break;
+	}
+	return "Guess";
+}
+
+/**
+ * @brief Loads the board values and computes the candidates.
+ * 
+ * @return false if two given values collide.
+ */
+template <unsigned SW, unsigned SH>
+const bool Grader::load_grid(const CompactBoard<SW, SH> &board, Grid<SW, SH> &grid) {
+	constexpr auto WIDTH = Grid<SW, SH>::WIDTH;
+	auto &units = CompactBoard<SW, SH>::units();
+
+	// Digits used by each unit
+	std::array<unsigned, 3 * WIDTH> used{};
+	for (unsigned u = 0; u < units.size(); u ++) {
+		for (auto i : units[u]) {
+			auto v = board.get(i);
+			if (!v) continue;
+			if (used[u] & (1u << (v - 1))) return false;
+			used[u] |= 1u << (v - 1);
+		}
+	}
+
+	grid.board = board;
+	grid.empty = 0;
+	for (unsigned i = 0; i < grid.SIZE; i ++) {
+		grid.candidates[i] = 0;
+		if (board.get(i)) continue;
+
+		auto mask = (1u << WIDTH) - 1;
+		for (auto u : CompactBoard<SW, SH>::units_of(i)) mask &= ~used[u];
+		grid.candidates[i] = mask;
+		grid.empty ++;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Places the value v in the cell i and removes it from the
+ * candidates of its peers.
+ */
+template <unsigned SW, unsigned SH>
+void Grader::place(Grid<SW, SH> &grid, const unsigned i, const unsigned v) {
+	auto &units = CompactBoard<SW, SH>::units();
+	auto bit = 1u << (v - 1);
+
+	grid.board.set(i, v);
+	grid.candidates[i] = 0;
+	grid.empty --;
+
+	for (auto u : CompactBoard<SW, SH>::units_of(i)) {
+		for (auto j : units[u]) grid.candidates[j] &= ~bit;
+	}
+}
+
+/**
+ * @brief Applies the easiest technique that makes progress.
+ * 
+ * @param grid Board being solved.
+ * @param step when not nullptr, receives the deduction.
+ * @return Technique the technique applied, GUESS if none applies.
+ */
+template <unsigned SW, unsigned SH>
+const Technique Grader::apply(Grid<SW, SH> &grid, GradeStep *step) {
+	if (naked_single(grid, step)) return Technique::NAKED_SINGLE;
+	if (hidden_single(grid, step)) return Technique::HIDDEN_SINGLE;
+	if (locked_candidates(grid, step)) return Technique::LOCKED_CANDIDATES;
+	if (naked_subset(grid, 2, step)) return Technique::NAKED_PAIR;
+	if (hidden_subset(grid, 2, step)) return Technique::HIDDEN_PAIR;
+	if (naked_subset(grid, 3, step)) return Technique::NAKED_TRIPLE;
+	if (hidden_subset(grid, 3, step)) return Technique::HIDDEN_TRIPLE;
+	if (x_wing(grid, step)) return Technique::X_WING;
+	return Technique::GUESS;
+}
+
+/**
+ * @brief Removes the digits of mask from the cells of the unit u,
+ * except from the cells accepted by keep.
+ * 
+ * @return true if a candidate was removed.
+ */
+template <unsigned SW, unsigned SH, class Keep>
+const bool Grader::remove(Grid<SW, SH> &grid, const unsigned u, const unsigned mask,
+		const Keep &keep, GradeStep *step) {
+	bool removed = false;
+	for (auto i : CompactBoard<SW, SH>::units()[u]) {
+		if (!(grid.candidates[i] & mask) || keep(i)) continue;
+		grid.candidates[i] &= ~mask;
+		removed = true;
+		if (step) step->eliminated.push_back(i);
+	}
+	return removed;
+}
+
+/**
+ * @brief Looks for n masks of the list whose union has n bits, and
+ * calls found with the chosen indexes (a bit per index) and the union
+ * until it returns true.
+ * 
+ * @return true if found returned true.
+ */
+template <class Masks, class Found>
+const bool Grader::find_subset(const Masks &masks, const unsigned count, const unsigned n,
+		const unsigned start, const unsigned chosen, const unsigned joined, const Found &found) {
+	if (unsigned(__builtin_popcount(chosen)) == n) return found(chosen, joined);
+
+	for (unsigned k = start; k < count; k ++) {
+		auto next = joined | masks[k];
+		if (unsigned(__builtin_popcount(next)) > n) continue;
+		if (find_subset(masks, count, n, k + 1, chosen | (1u << k), next, found)) return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Fills a cell with one candidate.
+ */
+template <unsigned SW, unsigned SH>
+const bool Grader::naked_single(Grid<SW, SH> &grid, GradeStep *step) {
+	for (unsigned i = 0; i < grid.SIZE; i ++) {
+		auto mask = grid.candidates[i];
+		if (!mask || (mask & (mask - 1))) continue;
+
+		auto v = unsigned(__builtin_ctz(mask)) + 1;
+		place(grid, i, v);
+		if (step) {
+			step->cell = i;
+			step->value = v;
+			step->digits = mask;
+			step->cells = {i};
+		}
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Fills the only cell of a digit in a unit.
+ */
+template <unsigned SW, unsigned SH>
+const bool Grader::hidden_single(Grid<SW, SH> &grid, GradeStep *step) {
+	for (auto &unit : CompactBoard<SW, SH>::units()) {
+		// Digits seen in one cell of the unit and in more than one.
+		unsigned once = 0, twice = 0;
+		for (auto i : unit) {
+			twice |= once & grid.candidates[i];
+			once |= grid.candidates[i];
+		}
+
+		auto singles = once & ~twice;
+		if (!singles) continue;
+
+		auto bit = singles & -singles;
+		for (auto i : unit) {
+			if (!(grid.candidates[i] & bit)) continue;
+
+			auto v = unsigned(__builtin_ctz(bit)) + 1;
+			place(grid, i, v);
+			if (step) {
+				step->cell = i;
+				step->value = v;
+				step->digits = bit;
+				step->cells.assign(unit.begin(), unit.end());
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Removes a digit confined to the cells a unit shares with
+ * another unit from the rest of the other unit (pointing and claiming).
+ */
+template <unsigned SW, unsigned SH>
+const bool Grader::locked_candidates(Grid<SW, SH> &grid, GradeStep *step) {
+	constexpr auto WIDTH = Grid<SW, SH>::WIDTH;
+	constexpr auto NONE = 3 * WIDTH;
+	auto &units = CompactBoard<SW, SH>::units();
+
+	for (unsigned from = 0; from < units.size(); from ++) {
+		for (unsigned bit = 1; bit < (1u << WIDTH); bit <<= 1) {
+			// Units shared by all the cells of the digit.
+			std::array<unsigned, 3> common{NONE, NONE, NONE};
+			unsigned count = 0;
+			for (auto i : units[from]) {
+				if (!(grid.candidates[i] & bit)) continue;
+
+				auto of = CompactBoard<SW, SH>::units_of(i);
+				for (unsigned k = 0; k < 3; k ++)
+					if (!count) common[k] = of[k];
+					else if (common[k] != of[k]) common[k] = NONE;
+				count ++;
+			}
+			if (count < 2) continue;
+
+			for (auto to : common) {
+				if (to == NONE || to == from) continue;
+
+				auto in_from = [&](const unsigned i) {
+					auto of = CompactBoard<SW, SH>::units_of(i);
+					return of[0] == from || of[1] == from || of[2] == from;
+				};
+				if (!remove(grid, to, bit, in_from, step)) continue;
+
+				if (step) {
+					step->digits = bit;
+					for (auto i : units[from])
+						if (grid.candidates[i] & bit) step->cells.push_back(i);
+				}
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Removes the digits of n cells of a unit with n candidates
+ * between them from the rest of the unit.
+ */
+template <unsigned SW, unsigned SH>
+const bool Grader::naked_subset(Grid<SW, SH> &grid, const unsigned n, GradeStep *step) {
+	constexpr auto WIDTH = Grid<SW, SH>::WIDTH;
+	auto &units = CompactBoard<SW, SH>::units();
+
+	for (unsigned u = 0; u < units.size(); u ++) {
+		// Empty cells with n candidates or fewer
+		std::array<unsigned, WIDTH> masks{}, cells{};
+		unsigned count = 0, empty = 0;
+		for (auto i : units[u]) {
+			auto mask = grid.candidates[i];
+			if (!mask) continue;
+			empty ++;
+			if (unsigned(__builtin_popcount(mask)) > n) continue;
+			masks[count] = mask;
+			cells[count ++] = i;
+		}
+		if (count < n || empty <= n) continue;
+
+		auto found = [&](const unsigned chosen, const unsigned digits) {
+			auto in_subset = [&](const unsigned i) {
+				for (unsigned k = 0; k < count; k ++)
+					if ((chosen >> k) & 1 && cells[k] == i) return true;
+				return false;
+			};
+			if (!remove(grid, u, digits, in_subset, step)) return false;
+
+			if (step) {
+				step->digits = digits;
+				for (unsigned k = 0; k < count; k ++)
+					if ((chosen >> k) & 1) step->cells.push_back(cells[k]);
+			}
+			return true;
+		};
+		if (find_subset(masks, count, n, 0, 0, 0, found)) return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Removes the other candidates of n cells of a unit holding
+ * the only places of n digits.
+ */
+template <unsigned SW, unsigned SH>
+const bool Grader::hidden_subset(Grid<SW, SH> &grid, const unsigned n, GradeStep *step) {
+	constexpr auto WIDTH = Grid<SW, SH>::WIDTH;
+	auto &units = CompactBoard<SW, SH>::units();
+
+	for (unsigned u = 0; u < units.size(); u ++) {
+		auto &unit = units[u];
+
+		// Places of each digit in the unit, a bit per position.
+		std::array<unsigned, WIDTH> places{};
+		unsigned empty = 0;
+		for (unsigned k = 0; k < WIDTH; k ++) {
+			auto mask = grid.candidates[unit[k]];
+			if (mask) empty ++;
+			for (; mask; mask &= mask - 1) places[__builtin_ctz(mask)] |= 1u << k;
+		}
+		if (empty <= n) continue;
+
+		// Digits with n places or fewer
+		std::array<unsigned, WIDTH> masks{}, digits{};
+		unsigned count = 0;
+		for (unsigned d = 0; d < WIDTH; d ++) {
+			if (!places[d] || unsigned(__builtin_popcount(places[d])) > n) continue;
+			masks[count] = places[d];
+			digits[count ++] = d;
+		}
+		if (count < n) continue;
+
+		auto found = [&](const unsigned chosen, const unsigned positions) {
+			unsigned keep = 0;
+			for (unsigned k = 0; k < count; k ++)
+				if ((chosen >> k) & 1) keep |= 1u << digits[k];
+
+			bool removed = false;
+			for (unsigned k = 0; k < WIDTH; k ++) {
+				if (!((positions >> k) & 1)) continue;
+				auto i = unit[k];
+				if (!(grid.candidates[i] & ~keep)) continue;
+				grid.candidates[i] &= keep;
+				removed = true;
+				if (step) step->eliminated.push_back(i);
+			}
+			if (!removed) return false;
+
+			if (step) {
+				step->digits = keep;
+				for (unsigned k = 0; k < WIDTH; k ++)
+					if ((positions >> k) & 1) step->cells.push_back(unit[k]);
+			}
+			return true;
+		};
+		if (find_subset(masks, count, n, 0, 0, 0, found)) return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Removes a digit held by the same two columns in two rows
+ * from the rest of the columns (and the other way around).
+ */
+template <unsigned SW, unsigned SH>
+const bool Grader::x_wing(Grid<SW, SH> &grid, GradeStep *step) {
+	constexpr auto WIDTH = Grid<SW, SH>::WIDTH;
+
+	for (unsigned bit = 1; bit < (1u << WIDTH); bit <<= 1) {
+		// Rows as base and columns as cover, then the other way.
+		for (unsigned base = 0; base < 2; base ++) {
+			auto cell = [base](const unsigned line, const unsigned k) {
+				return base ? k * WIDTH + line : line * WIDTH + k;
+			};
+			auto line_of = [base](const unsigned i) { return base ? i % WIDTH : i / WIDTH; };
+
+			// Lines with two places for the digit
+			std::array<unsigned, WIDTH> masks{}, lines{};
+			unsigned count = 0;
+			for (unsigned line = 0; line < WIDTH; line ++) {
+				unsigned places = 0;
+				for (unsigned k = 0; k < WIDTH; k ++)
+					if (grid.candidates[cell(line, k)] & bit) places |= 1u << k;
+				if (__builtin_popcount(places) != 2) continue;
+				masks[count] = places;
+				lines[count ++] = line;
+			}
+			if (count < 2) continue;
+
+			auto found = [&](const unsigned chosen, const unsigned covers) {
+				auto in_base = [&](const unsigned i) {
+					for (unsigned k = 0; k < count; k ++)
+						if ((chosen >> k) & 1 && lines[k] == line_of(i)) return true;
+					return false;
+				};
+
+				bool removed = false;
+				for (unsigned k = 0; k < WIDTH; k ++) {
+					if (!((covers >> k) & 1)) continue;
+					auto cover = base ? k : WIDTH + k;
+					removed = remove(grid, cover, bit, in_base, step) || removed;
+				}
+				if (!removed) return false;
+
+				if (step) {
+					step->digits = bit;
+					for (unsigned k = 0; k < count; k ++) {
+						if (!((chosen >> k) & 1)) continue;
+						for (unsigned c = 0; c < WIDTH; c ++)
+							if ((covers >> c) & 1) step->cells.push_back(cell(lines[k], c));
+					}
+				}
+				return true;
+			};
+			if (find_subset(masks, count, 2, 0, 0, 0, found)) return true;
+		}
+	}
+
+	return false;
+}
+
+// Board geometries supported by the compact representation.
+template Grade Grader::grade(const CompactBoard<2, 2> &, std::vector<GradeStep> *);
+template Grade Grader::grade(const CompactBoard<3, 2> &, std::vector<GradeStep> *);
+template Grade Grader::grade(const CompactBoard<3, 3> &, std::vector<GradeStep> *);
+template Grade Grader::grade(const CompactBoard<4, 4> &, std::vector<GradeStep> *);
+template Grade Grader::grade(const CompactBoard<5, 5> &, std::vector<GradeStep> *);
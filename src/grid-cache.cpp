@@ -0,0 +1,170 @@
+/**
+ * @file grid-cache.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of grid-cache.h
+ * @date 2024-09-27
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <grid-cache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <string>
+
+/**
+ * @brief Returns the cache of a board geometry and cell size,
+ * rendering it the first time.
+ * 
+ * @param cr Cairo context of the widget (the surfaces are similar to its target).
+ * @param board Board to draw.
+ * @param s_size cell size.
+ * @return GridCache& the cache.
+ */
+GridCache &GridCache::get(const Cairo::RefPtr<Cairo::Context>& cr, const Board &board,
+		const double s_size) {
+	// Most recently used first: the board area and the collection
+	// thumbnails. A mixed collection shows the thumbnails of every
+	// supported geometry (4x4, 6x6, 9x9, 16x16 and 25x25), each at
+	// its own cell size, next to the board area: all of them fit.
+	static std::list<GridCache> caches;
+	const unsigned max_caches = 5 + 1;
+
+	for (auto it = caches.begin(); it != caches.end(); it ++) {
+		if (it->width != board.get_width() || it->sw != board.get_sw() ||
+				it->sh != board.get_sh() || it->s_size != s_size) continue;
+		caches.splice(caches.begin(), caches, it);
+		return caches.front();
+	}
+
+	if (caches.size() >= max_caches) caches.pop_back();
+
+	caches.emplace_front();
+	auto &cache = caches.front();
+	cache.width = board.get_width();
+	cache.sw = board.get_sw();
+	cache.sh = board.get_sh();
+	cache.s_size = s_size;
+	cache.render(cr);
+
+	return cache;
+}
+
+/**
+ * @brief Renders the surfaces.
+ */
+void GridCache::render(const Cairo::RefPtr<Cairo::Context>& cr) {
+	auto target = cr->get_target();
+	int size = int(std::ceil(s_size * width)) + 1;
+
+	// Grid lines
+	lines = Cairo::Surface::create(target, Cairo::CONTENT_COLOR_ALPHA, size, size);
+	auto lc = Cairo::Context::create(lines);
+
+	lc->set_source_rgb(0, 0, 0);
+	lc->set_line_width(s_size * 0.02);
+	for (unsigned y = 0; y < width; y ++)
+		for (unsigned x = 0; x < width; x ++)
+			lc->rectangle(x * s_size, y * s_size, s_size, s_size);
+	lc->stroke();
+
+	// Separators between the squares
+	lc->set_line_width(s_size * 0.09);
+	for (unsigned x = sw; x < width; x += sw) {
+		lc->move_to(s_size * x, 0);
+		lc->line_to(s_size * x, s_size * width);
+	}
+	for (unsigned y = sh; y < width; y += sh) {
+		lc->move_to(0, s_size * y);
+		lc->line_to(s_size * width, s_size * y);
+	}
+	lc->stroke();
+
+	// Glyphs: fixed values on the first row, user values on the second,
+	// notes on the third.
+	glyphs = Cairo::Surface::create(target, Cairo::CONTENT_COLOR_ALPHA,
+			int(std::ceil(s_size * width)), int(std::ceil(s_size * 3)));
+	auto gc = Cairo::Context::create(glyphs);
+
+	// Two digit values (16x16 and 25x25 boards) need a smaller font.
+	auto scale = width > 9 ? 0.7 : 1.0;
+
+	gc->select_font_face("sans", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_BOLD);
+	gc->set_font_size(s_size * 0.7 * scale);
+	for (unsigned row = 0; row < 2; row ++) {
+		if (row == 0) gc->set_source_rgb(0, 0, 0);
+		else gc->set_source_rgb(0.1, 0.25, 0.6);
+
+		for (unsigned v = 1; v <= width; v ++) {
+			auto text = std::to_string(v);
+			Cairo::TextExtents extents;
+			gc->get_text_extents(text, extents);
+
+			gc->move_to((v - 1) * s_size + (s_size - extents.x_advance) / 2,
+					row * s_size + s_size * (0.5 + 0.3 * scale));
+			gc->show_text(text);
+		}
+	}
+
+	// Notes: each digit in the top left box of its column (sw x sh boxes per cell).
+	auto box_w = s_size / sw, box_h = s_size / sh;
+	gc->select_font_face("sans", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_NORMAL);
+	gc->set_font_size(std::min(box_w, box_h) * 0.75 * scale);
+	gc->set_source_rgb(0.45, 0.45, 0.45);
+	for (unsigned v = 1; v <= width; v ++) {
+		auto text = std::to_string(v);
+		Cairo::TextExtents extents;
+		gc->get_text_extents(text, extents);
+
+		gc->move_to((v - 1) * s_size + (box_w - extents.x_advance) / 2,
+				2 * s_size + (box_h - extents.height) / 2 - extents.y_bearing);
+		gc->show_text(text);
+	}
+}
+
+/**
+ * @brief Paints the pencil marks of the cell xy, each digit at its
+ * place in a sw x sh grid inside the cell.
+ * 
+ * @param notes bit (v - 1) set for each noted digit v.
+ */
+void GridCache::paint_notes(const Cairo::RefPtr<Cairo::Context>& cr, const unsigned x,
+		const unsigned y, const unsigned notes) const {
+	auto box_w = s_size / sw, box_h = s_size / sh;
+
+	for (unsigned v = 1; v <= width; v ++) {
+		if (!(notes & (1u << (v - 1)))) continue;
+
+		auto left = x * s_size + ((v - 1) % sw) * box_w;
+		auto top = y * s_size + ((v - 1) / sw) * box_h;
+		cr->set_source(glyphs, left - (v - 1) * s_size, top - 2 * s_size);
+		cr->rectangle(left, top, box_w, box_h);
+		cr->fill();
+	}
+}
+
+/**
+ * @brief Paints the cell borders and the square separators.
+ */
+void GridCache::paint_lines(const Cairo::RefPtr<Cairo::Context>& cr) const {
+	cr->set_source(lines, 0, 0);
+	cr->paint();
+}
+
+/**
+ * @brief Paints a digit in the cell xy.
+ * 
+ * @param value digit to paint.
+ * @param fixed true for the style of the fixed values.
+ */
+void GridCache::paint_digit(const Cairo::RefPtr<Cairo::Context>& cr, const unsigned x,
+		const unsigned y, const unsigned value, const bool fixed) const {
+	if (!value || value > width) return;
+
+	double row = fixed ? 0 : 1;
+	cr->set_source(glyphs, (double(x) - (value - 1)) * s_size, (double(y) - row) * s_size);
+	cr->rectangle(x * s_size, y * s_size, s_size, s_size);
+	cr->fill();
+}
@@ -17,6 +17,7 @@
 #include <dialogs/new-game-dialog.h>
 #include <board-area.h>
 #include <board.h>
+#include <grader.h>
 
 /**
  * @brief Construct a new MainMenu object.
@@ -31,6 +32,24 @@ MainMenu::MainMenu(BaseObjectType* obj, Glib::RefPtr<Gtk::Builder> const& builde
 	builder->get_widget("reset-board-menu-item", item);
 	item->signal_activate().connect([this]() { this->menu_reset_board(); });
 
+	builder->get_widget("undo-menu-item", item);
+	item->signal_activate().connect([this]() { this->menu_undo(); });
+
+	builder->get_widget("redo-menu-item", item);
+	item->signal_activate().connect([this]() { this->menu_redo(); });
+
+	Gtk::CheckMenuItem *notes_item;
+	builder->get_widget("notes-menu-item", notes_item);
+	notes_item->signal_toggled().connect([this, notes_item]() {
+		this->menu_notes(notes_item->get_active());
+	});
+
+	builder->get_widget("fill-notes-menu-item", item);
+	item->signal_activate().connect([this]() { this->menu_fill_notes(); });
+
+	builder->get_widget("hint-menu-item", item);
+	item->signal_activate().connect([this]() { this->menu_hint(); });
+
 	builder->get_widget("welcome-menu-item", item);
 	item->signal_activate().connect([this]() { this->menu_welcome_window(); });
 
@@ -91,13 +110,88 @@ void MainMenu::menu_reset_board() const {
 
 	int result = dialog.run();
 	if (result == Gtk::RESPONSE_YES) {
-		app->get_board().reset();
+		app->reset_board();
 		app->get_main_window()->get_board_area()->queue_draw();
-		app->save_board();
 		app->get_player().save_config(app);
 	}
 }
 
+/**
+ * @brief On Undo item click.
+ * 
+ */
+void MainMenu::menu_undo() const {
+	app->get_main_window()->get_board_area()->undo();
+}
+
+/**
+ * @brief On Redo item click.
+ * 
+ */
+void MainMenu::menu_redo() const {
+	app->get_main_window()->get_board_area()->redo();
+}
+
+/**
+ * @brief On Notes item toggle.
+ * 
+ * @param active true to enter the notes mode.
+ */
+void MainMenu::menu_notes(const bool active) const {
+	app->get_main_window()->get_board_area()->set_notes_mode(active);
+}
+
+/**
+ * @brief On Fill Notes item click.
+ * 
+ */
+void MainMenu::menu_fill_notes() const {
+	app->fill_notes();
+	app->get_main_window()->get_board_area()->queue_draw();
+}
+
+/**
+ * @brief On Hint item click.
+ * A wrong value is shown first: the deductions from it would be wrong too.
+ * 
+ */
+void MainMenu::menu_hint() const {
+	auto board_area = app->get_main_window()->get_board_area();
+	auto &board = app->get_board();
+	auto &solved = app->get_solved();
+
+	if (board.is_solved()) return;
+
+	Gtk::MessageDialog dialog(*app->get_main_window(), "Hint", false, Gtk::MESSAGE_INFO, Gtk::BUTTONS_OK);
+
+	// The solution of a loaded board may still be on its way.
+	unsigned width = board.get_width();
+	for (unsigned y = 0; y < width && solved.full(); y ++) {
+		for (unsigned x = 0; x < width; x ++) {
+			auto cell = board.get(x, y);
+			if (cell.value == 0 || cell.value == solved.get(x, y).value) continue;
+
+			board_area->show_hint(x, y, true, {});
+			dialog.set_message("Wrong value");
+			dialog.set_secondary_text("The selected cell does not match the solution.");
+			dialog.run();
+			return;
+		}
+	}
+
+	GradeStep hint;
+	if (!Grader::hint(board, hint)) {
+		dialog.set_secondary_text("No logical step is left: a value has to be guessed.");
+		dialog.run();
+		return;
+	}
+
+	board_area->show_hint(hint.cell % width, hint.cell / width, false, hint.cells);
+	dialog.set_message(Grader::technique_name(hint.technique));
+	dialog.set_secondary_text("The selected cell can be filled: the highlighted cells show why.");
+	dialog.run();
+}
+
 /**
  * @brief On Check welcome window item click;
  * 
@@ -0,0 +1,299 @@
+/**
+ * @file move-journal.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of move-journal.h
+ * @date 2024-10-06
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <move-journal.h>
+
+#include <save-queue.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief First line of the log files.
+ * 
+ */
+static const std::string journal_header = "sudoku-journal 1";
+
+/**
+ * @brief Returns the current time in milliseconds since epoch.
+ */
+static long long now_ms() {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Returns the record of a move, without the line end.
+ */
+static std::string move_record(const MoveJournal::Move &move) {
+	auto record = "m " + std::to_string(move.cell) + " " + std::to_string(move.old_value) + " " +
+			std::to_string(move.new_value) + " " + std::to_string(move.time);
+	for (auto &note : move.notes)
+		record += " " + std::to_string(note.first) + ":" + std::to_string(note.second);
+	return record;
+}
+
+/**
+ * @brief Starts a new log for a board, replacing the file.
+ * 
+ * @param path log file path.
+ * @param board board at the start of the log.
+ * @param queue queue of the file writes.
+ */
+void MoveJournal::start(const std::string path, const Board &board, SaveQueue &queue) {
+	this->path = path;
+	this->queue = &queue;
+	base.clear();
+	moves.clear();
+	first = 0;
+	position = 0;
+
+	auto w = board.get_width();
+	for (unsigned i = 0; i < board.get_size(); i ++)
+		base += Board::symbol(board.get(i % w, i / w).value);
+
+	rewrite();
+}
+
+/**
+ * @brief Opens the log of a board and replays it onto the board.
+ * 
+ * @param path log file path.
+ * @param board board to update (its fixed values are kept).
+ * @param queue queue of the file writes.
+ * @return false if the file is missing or does not match the board
+ * (the board is not changed).
+ */
+const bool MoveJournal::open(const std::string path, Board &board, SaveQueue &queue) {
+	std::ifstream in(path);
+	std::string line;
+	if (!std::getline(in, line) || line != journal_header) return false;
+
+	std::string values;
+	if (!std::getline(in, line) || line.compare(0, 5, "base ") != 0) return false;
+	values = line.substr(5);
+	if (values.size() != board.get_size()) return false;
+
+	std::vector<Move> log;
+	std::size_t applied = 0;
+	unsigned count = 0;
+	while (std::getline(in, line)) {
+		if (line.empty()) continue;
+		count ++;
+
+		std::istringstream fields(line);
+		char type;
+		fields >> type;
+		if (type == 'u' && applied > 0) applied --;
+		else if (type == 'r' && applied < log.size()) applied ++;
+		else if (type == 'm') {
+			Move move;
+			fields >> move.cell >> move.old_value >> move.new_value >> move.time;
+			// A truncated last record (crash during the append) is ignored.
+			if (!fields || move.cell >= values.size() || move.new_value > board.get_width()) continue;
+
+			// Pruned notes, "cell:notes" (older logs have none).
+			std::string note;
+			while (fields >> note) {
+				unsigned cell, notes;
+				char colon;
+				std::istringstream pair(note);
+				if (pair >> cell >> colon >> notes && colon == ':' && cell < values.size())
+					move.notes.emplace_back(cell, notes);
+			}
+
+			log.resize(applied);
+			log.push_back(move);
+			applied ++;
+		}
+	}
+
+	// Start values, then the applied moves with their pruned notes.
+	// Fixed cells are not changed.
+	auto w = board.get_width();
+	for (unsigned i = 0; i < values.size(); i ++) {
+		if (board.get(i % w, i / w).fixed) continue;
+		board.set(i % w, i / w, {Board::symbol_value(values[i]), false});
+	}
+	for (std::size_t i = 0; i < applied; i ++) {
+		auto &move = log[i];
+		if (board.get(move.cell % w, move.cell / w).fixed) continue;
+		board.set(move.cell % w, move.cell / w, {move.new_value, false});
+		board.prune_notes(move.cell % w, move.cell / w, move.new_value);
+	}
+
+	this->path = path;
+	this->queue = &queue;
+	base = values;
+	moves = log;
+	first = 0;
+	position = applied;
+	records = count;
+
+	return true;
+}
+
+/**
+ * @brief Stops logging: the next moves are not recorded.
+ */
+void MoveJournal::close() {
+	path.clear();
+	queue = nullptr;
+	base.clear();
+	moves.clear();
+	first = 0;
+	position = 0;
+	records = 0;
+}
+
+/**
+ * @brief Sets a value on the board, removes it from the notes of
+ * the row, column and box of the cell, and records the move.
+ * The moves that could be redone are discarded.
+ */
+void MoveJournal::play(Board &board, const unsigned x, const unsigned y, const unsigned value) {
+	auto old = board.get(x, y).value;
+	if (old == value) return;
+
+	auto w = board.get_width();
+	Move move{y * w + x, old, value, now_ms(), {}};
+
+	// Notes before the move, to restore the pruned ones on undo.
+	std::vector<unsigned> notes;
+	if (board.has_notes()) {
+		notes.resize(board.get_size());
+		for (unsigned i = 0; i < notes.size(); i ++) notes[i] = board.get_notes(i % w, i / w);
+	}
+
+	board.set(x, y, {value, false});
+	board.prune_notes(x, y, value);
+	if (path.empty()) return;
+
+	for (unsigned i = 0; i < notes.size(); i ++) {
+		if (board.get_notes(i % w, i / w) != notes[i]) move.notes.emplace_back(i, notes[i]);
+	}
+
+	moves.resize(position);
+	moves.push_back(move);
+	position ++;
+
+	append(move_record(move));
+}
+
+/**
+ * @brief Reverts the last move and restores the notes it pruned.
+ * 
+ * @param board board to update.
+ * @param x, y set to the cell of the move.
+ * @return false if there is no move to undo.
+ */
+const bool MoveJournal::undo(Board &board, unsigned &x, unsigned &y) {
+	if (!can_undo()) return false;
+
+	auto w = board.get_width();
+	auto &move = moves[-- position];
+	x = move.cell % w;
+	y = move.cell / w;
+	board.set(x, y, {move.old_value, false});
+	for (auto &note : move.notes) board.set_notes(note.first % w, note.first / w, note.second);
+
+	if (position >= first) append("u");
+	else {
+		// The move is in the start values: they go back one move.
+		base[move.cell] = Board::symbol(move.old_value);
+		first = position;
+		rewrite();
+	}
+	return true;
+}
+
+/**
+ * @brief Plays again the last undone move.
+ * 
+ * @param board board to update.
+ * @param x, y set to the cell of the move.
+ * @return false if there is no move to redo.
+ */
+const bool MoveJournal::redo(Board &board, unsigned &x, unsigned &y) {
+	if (!can_redo()) return false;
+
+	auto &move = moves[position ++];
+	x = move.cell % board.get_width();
+	y = move.cell / board.get_width();
+	board.set(x, y, {move.new_value, false});
+	board.prune_notes(x, y, move.new_value);
+
+	append("r");
+	return true;
+}
+
+/**
+ * @brief Moves the start values to the current board and queues
+ * the rewrite of the file with the moves that can be redone.
+ * 
+ * @return false if the log is closed.
+ */
+const bool MoveJournal::compact() {
+	if (path.empty()) return false;
+
+	for (auto i = first; i < position; i ++) base[moves[i].cell] = Board::symbol(moves[i].new_value);
+	first = position;
+
+	rewrite();
+	return true;
+}
+
+/**
+ * @brief Appends a record to the file, or queues the rewrite of
+ * the file while a rewrite is pending.
+ */
+void MoveJournal::append(const std::string record) {
+	// A pending rewrite would replace the appended record.
+	if (queue->is_pending(path)) {
+		rewrite();
+		return;
+	}
+
+	// Opened for each record: a compaction replaces the file.
+	auto line = record + "\n";
+	auto fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+	if (fd < 0 || write(fd, line.data(), line.size()) != ssize_t(line.size()))
+		std::cerr << "Error: cannot append to the move journal: " << path << "." << std::endl;
+	if (fd >= 0) ::close(fd);
+
+	records ++;
+}
+
+/**
+ * @brief Queues the rewrite of the file.
+ */
+void MoveJournal::rewrite() {
+	auto data = serialize();
+	queue->save(path, [data]() { return data; });
+	records = 2 * (moves.size() - first) - (position - first);
+}
+
+/**
+ * @brief Returns the content of the file: the start values and the
+ * moves played after them.
+ */
+const std::string MoveJournal::serialize() const {
+	std::string data = journal_header + "\nbase " + base + "\n";
+	for (auto i = first; i < moves.size(); i ++) data += move_record(moves[i]) + "\n";
+
+	// The undone moves stay for redo.
+	for (auto i = position; i < moves.size(); i ++) data += "u\n";
+
+	return data;
+}
@@ -17,7 +17,6 @@
 #include <sudoku.h>
 
 #include <libxml/parser.h>
-#include <assert.h>
 
 /**
  * @brief Create a new player.
@@ -79,11 +78,15 @@ void Player::save_config(SudokuApp *app) const {
 
 	std::cout << "Saving player config: " << path << "." << std::endl;
 
-	auto result = xmlSaveFormatFileEnc(path.c_str(), doc, "UTF-8", 1);
-	assert(result != -1 && "Sudoku configuration: Cannot save xml file.");
+	xmlChar *buffer = nullptr;
+	int length = 0;
+	xmlDocDumpFormatMemoryEnc(doc, &buffer, &length, "UTF-8", 1);
+	std::string xml = buffer ? std::string((char *)buffer, length) : "";
 
+	xmlFree(buffer);
 	xmlFreeDoc(doc);
-	xmlCleanupParser();
+
+	app->get_save_queue().save(path, [xml]() { return xml; });
 }
 
 /**
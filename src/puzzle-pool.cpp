@@ -0,0 +1,184 @@
+/**
+ * @file puzzle-pool.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of puzzle-pool.h
+ * @date 2024-09-12
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <puzzle-pool.h>
+
+#include <generator.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <sys/resource.h>
+
+/**
+ * @brief Sizes and difficulties kept in the pool.
+ * The 16x16 and 25x25 boards take seconds to generate: the pool keeps
+ * no more than large_watermark of them.
+ * 
+ */
+static const unsigned pool_sizes[] = {81, 16, 36, 256, 625};
+static const unsigned pool_difficulties[] = {0, 1, 2};
+static const unsigned large_watermark = 2;
+
+/**
+ * @brief Reads the lines of a pool file.
+ */
+static std::vector<std::string> read_lines(const std::string path);
+
+/**
+ * @brief Construct a new PuzzlePool and start the refill thread.
+ * 
+ * @param path directory of the pool files (ending with '/').
+ * @param watermark boards kept ready for each size and difficulty.
+ */
+PuzzlePool::PuzzlePool(const std::string path, const unsigned watermark) :
+		path{path}, watermark{watermark} {
+	thread = std::thread([this]() { this->run_refill(); });
+}
+
+/**
+ * @brief Stop the refill thread.
+ */
+PuzzlePool::~PuzzlePool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+	thread.join();
+}
+
+/**
+ * @brief Takes a ready board from the pool.
+ * 
+ * @param size the size of the board.
+ * @param difficulty 0: Easy, 1: Medium, 2: Hard.
+ * @param board the board, with a new id.
+ * @param solved the solution of the board.
+ * @return false if the pool is empty.
+ */
+const bool PuzzlePool::pop(const unsigned size, const unsigned difficulty,
+		Board &board, Board &solved) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto file = file_path(size, difficulty);
+	auto lines = read_lines(file);
+	if (lines.empty()) return false;
+
+	auto line = lines.back();
+	lines.pop_back();
+
+	// Rewrite the pool without the board, replacing the file at once.
+	std::ofstream out(file + ".tmp", std::ios::trunc);
+	for (auto &l : lines) out << l << '\n';
+	out.close();
+	std::rename((file + ".tmp").c_str(), file.c_str());
+
+	refill = true;
+	lock.unlock();
+	condition.notify_all();
+
+	if (line.size() != 2 * size + 1) return false;
+
+	board = Board(size);
+	board.set_difficulty(Generator::difficulty_name(difficulty));
+	solved = board;
+
+	auto w = board.get_width();
+	for (unsigned i = 0; i < size; i ++) {
+		unsigned given = Board::symbol_value(line[i]), value = Board::symbol_value(line[size + 1 + i]);
+		board.set(i % w, i / w, {given, given != 0});
+		solved.set(i % w, i / w, {value, given != 0});
+	}
+
+	std::cout << "Board taken from pool: " << file << "." << std::endl;
+
+	return true;
+}
+
+/**
+ * @brief Returns the number of ready boards of a size and difficulty.
+ */
+const unsigned PuzzlePool::count(const unsigned size, const unsigned difficulty) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return read_lines(file_path(size, difficulty)).size();
+}
+
+/**
+ * @brief Returns the pool file path of a size and difficulty.
+ */
+const std::string PuzzlePool::file_path(const unsigned size, const unsigned difficulty) const {
+	return path + "pool-" + std::to_string(size) + "-" + std::to_string(difficulty) + ".txt";
+}
+
+/**
+ * @brief Generates and appends a board to a pool.
+ * 
+ * @return false if the generation was cancelled.
+ */
+const bool PuzzlePool::push_new(const unsigned size, const unsigned difficulty) {
+	Board solved;
+	auto board = Generator::generate_graded(size, difficulty, &stopping, &solved);
+	if (board.empty()) return false;
+
+	std::string line;
+	auto w = board.get_width();
+	for (unsigned i = 0; i < size; i ++) line += Board::symbol(board.get(i % w, i / w).value);
+	line += ' ';
+	for (unsigned i = 0; i < size; i ++) line += Board::symbol(solved.get(i % w, i / w).value);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	std::ofstream out(file_path(size, difficulty), std::ios::app);
+	out << line << '\n';
+
+	return true;
+}
+
+/**
+ * @brief Refill thread loop.
+ * 
+ */
+void PuzzlePool::run_refill() {
+	// Lowest priority for this thread only (Linux threads have their own nice value).
+	setpriority(PRIO_PROCESS, 0, 19);
+
+	while (!stopping) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			refill = false;
+		}
+
+		for (auto size : pool_sizes) {
+			auto target = size > 81 ? std::min(watermark, large_watermark) : watermark;
+			for (auto difficulty : pool_difficulties) {
+				while (!stopping && count(size, difficulty) < target) {
+					if (!push_new(size, difficulty)) break;
+				}
+			}
+		}
+
+		// Sleep until a board is taken.
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [this]() { return stopping || refill; });
+	}
+}
+
+/**
+ * @brief Reads the lines of a pool file.
+ */
+static std::vector<std::string> read_lines(const std::string path) {
+	std::vector<std::string> lines;
+	std::ifstream in(path);
+	std::string line;
+	while (std::getline(in, line)) if (!line.empty()) lines.push_back(line);
+	return lines;
+}
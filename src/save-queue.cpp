@@ -0,0 +1,159 @@
+/**
+ * @file save-queue.cpp
+ * @author Javier Candales (codigo.mate.9@gmail.com)
+ * @brief Implementation of save-queue.h
+ * @date 2024-10-04
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <save-queue.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Construct a new SaveQueue and start its worker.
+ */
+SaveQueue::SaveQueue() {
+	worker = std::thread([this]() { this->run(); });
+}
+
+/**
+ * @brief Write the queued files and join the worker.
+ */
+SaveQueue::~SaveQueue() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	condition.notify_all();
+	worker.join();
+}
+
+/**
+ * @brief Queues the write of a file, replacing a pending write of
+ * the same file.
+ * 
+ * @param path file path.
+ * @param serializer builds the content (must own its data).
+ * @param last moves a pending write of the file to the end of the
+ * queue, after the files queued since.
+ */
+void SaveQueue::save(const std::string path, Serializer serializer, const bool last) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = pending.find(path);
+		if (it != pending.end()) {
+			it->second = std::move(serializer);
+			if (last) {
+				order.erase(std::find(order.begin(), order.end(), path));
+				order.push_back(path);
+			}
+		} else {
+			pending.emplace(path, std::move(serializer));
+			order.push_back(path);
+		}
+	}
+
+	condition.notify_all();
+}
+
+/**
+ * @brief Waits until the queued files are written.
+ */
+void SaveQueue::flush() {
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this]() { return order.empty() && !writing; });
+}
+
+/**
+ * @brief Returns true while a write of a file is queued or running.
+ * @param path file path.
+ */
+const bool SaveQueue::is_pending(const std::string path) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending.count(path) || (writing && current == path);
+}
+
+/**
+ * @brief Replaces a file at once: writes a temporary file with a
+ * unique name, syncs it to disk and renames it over the file. A power
+ * loss leaves the old or the new content, never a truncated file, and
+ * concurrent writes of a file leave one of them.
+ * 
+ * @param path file path.
+ * @param data file content.
+ * @return false if the file cannot be written (it is not changed).
+ */
+const bool SaveQueue::write_file(const std::string path, const std::string &data) {
+	// A unique temporary file: threads writing the same file at once
+	// do not mix their content.
+	auto tmp = path + ".XXXXXX";
+
+	auto fd = mkostemp(&tmp[0], O_CLOEXEC);
+	if (fd < 0) {
+		std::cerr << "Error: cannot write file: " << tmp << "." << std::endl;
+		return false;
+	}
+
+	bool ok = fchmod(fd, 0644) == 0;
+	for (std::size_t done = 0; ok && done < data.size(); ) {
+		auto n = write(fd, data.data() + done, data.size() - done);
+		if (n >= 0) done += n;
+		else if (errno != EINTR) ok = false;
+	}
+	ok = fsync(fd) == 0 && ok;
+	ok = close(fd) == 0 && ok;
+
+	if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+		std::cerr << "Error: cannot write file: " << path << "." << std::endl;
+		std::remove(tmp.c_str());
+		return false;
+	}
+
+	// Sync the directory entry of the renamed file
+	auto slash = path.rfind('/');
+	auto dir = slash == std::string::npos ? std::string(".") : path.substr(0, slash + 1);
+	auto dfd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (dfd >= 0) {
+		fsync(dfd);
+		close(dfd);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Writer thread loop.
+ * 
+ */
+void SaveQueue::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true) {
+		condition.wait(lock, [this]() { return stopping || !order.empty(); });
+		if (order.empty()) return; // stopping, nothing left to write
+
+		auto path = order.front();
+		order.pop_front();
+		auto serializer = std::move(pending[path]);
+		pending.erase(path);
+		writing = true;
+		current = path;
+
+		lock.unlock();
+		if (!write_file(path, serializer())) failures ++;
+		lock.lock();
+
+		writing = false;
+		condition.notify_all();
+	}
+}
@@ -9,49 +9,461 @@
  */
 #include <solver.h>
 
-#include <cmath>
-
 /**
  * @brief Solve a Sudoku board and return the solutions.
  * 
  * @param board Board to solve.
  * @param max_solutions maximum of solutions to find. -1 to all.
+ * @param options search settings.
+ * @return std::list<Board> list of solutions.
+ */
+std::list<Board> Solver::solve(const Board &board, const unsigned max_solutions,
+		const SolverOptions &options) {
+	return visit_compact(board.get_sw(), board.get_sh(), [&](auto compact) {
+		return solve(decltype(compact)(board), board, max_solutions, options);
+	});
+}
+
+/**
+ * @brief Counts the solutions of a Sudoku board without building them.
+ * 
+ * @param board Board to solve.
+ * @param limit stop counting when this number is reached. -1 to all.
+ * @param options search settings.
+ * @return const unsigned the number of solutions found.
+ */
+const unsigned Solver::count_solutions(const Board &board, const unsigned limit,
+		const SolverOptions &options) {
+	return visit_compact(board.get_sw(), board.get_sh(), [&](auto compact) {
+		return count_solutions(decltype(compact)(board), limit, options);
+	});
+}
+
+/**
+ * @brief Returns true when the board has exactly one solution.
+ * The search stops at the second solution.
+ */
+const bool Solver::has_unique_solution(const Board &board) {
+	return count_solutions(board, 2) == 1;
+}
+
+/**
+ * @brief Fills the cells forced by the values of the board, without
+ * branching. The new values are not fixed.
+ * 
+ * @param board Board to fill.
+ * @return false if the board has no solution (the board is not changed).
+ */
+const bool Solver::propagate(Board &board) {
+	return visit_compact(board.get_sw(), board.get_sh(), [&](auto compact) {
+		using Compact = decltype(compact);
+		State<Compact::SQUARE_W, Compact::SQUARE_H> state;
+
+		if (!load_state(Compact(board), state, SolverOptions())) return false;
+		state.board.store(board);
+		return true;
+	});
+}
+
+/**
+ * @brief Returns the candidates of each cell: the digits not used in
+ * its row, column and square. Filled cells have no candidates.
+ * 
+ * @param board Board to check (repeated values are allowed).
+ * @return std::vector<unsigned> a mask per cell, bit (v - 1) for the digit v.
+ */
+std::vector<unsigned> Solver::candidate_masks(const Board &board) {
+	return visit_compact(board.get_sw(), board.get_sh(), [&](auto compact) {
+		using Compact = decltype(compact);
+		State<Compact::SQUARE_W, Compact::SQUARE_H> state;
+
+		// The masks of the values on the board, without checks nor propagation.
+		state.board = Compact(board);
+		for (unsigned i = 0; i < state.SIZE; i ++)
+			if (auto v = state.board.get(i)) place(state, i, v);
+
+		std::vector<unsigned> masks(state.SIZE);
+		for (unsigned i = 0; i < state.SIZE; i ++)
+			if (!state.board.get(i)) masks[i] = candidates(state, i);
+		return masks;
+	});
+}
+
+/**
+ * @brief Counts the solutions of a compact board.
+ * 
+ * @param board Board to solve.
+ * @param limit stop counting when this number is reached. -1 to all.
+ * @param options search settings.
+ * @return const unsigned the number of solutions found.
+ */
+template <unsigned SW, unsigned SH>
+const unsigned Solver::count_solutions(const CompactBoard<SW, SH> &board,
+		const unsigned limit, const SolverOptions &options) {
+	State<SW, SH> state;
+	unsigned found = 0;
+	auto on_solution = [](const State<SW, SH> &) {};
+
+	if (!load_state(board, state, options)) return 0;
+	solve(state, options, 0, on_solution, found, limit);
+	return found;
+}
+
+/**
+ * @brief Replaces the values of a compact board with its first solution.
+ * 
+ * @param board Board to solve.
+ * @param options search settings.
+ * @return false if the board has no solution (the board is not changed).
+ */
+template <unsigned SW, unsigned SH>
+const bool Solver::solve_first(CompactBoard<SW, SH> &board, const SolverOptions &options) {
+	State<SW, SH> state;
+	unsigned found = 0;
+	auto on_solution = [&board](const State<SW, SH> &solved) { board = solved.board; };
+
+	if (!load_state(board, state, options)) return false;
+	solve(state, options, 0, on_solution, found, 1);
+	return found == 1;
+}
+
+/**
+ * @brief Solve a compact board and return the solutions as copies
+ * of the given board.
+ * 
+ * @param compact Compact copy of board.
+ * @param board Board to solve, used as model for the solutions.
+ * @param max_solutions maximum of solutions to find. -1 to all.
+ * @param options search settings.
  * @return std::list<Board> list of solutions.
  */
-std::list<Board> Solver::solve(const Board &board, const unsigned max_solutions) {
+template <unsigned SW, unsigned SH>
+std::list<Board> Solver::solve(const CompactBoard<SW, SH> &compact, const Board &board,
+		const unsigned max_solutions, const SolverOptions &options) {
 	std::list<Board> solutions;
-	Board copy = board;
-	solve(copy, solutions, max_solutions);
+	State<SW, SH> state;
+	unsigned found = 0;
+	auto on_solution = [&](const State<SW, SH> &solved) {
+		solutions.push_back(board);
+		solved.board.store(solutions.back());
+	};
+
+	if (!load_state(compact, state, options)) return solutions;
+	solve(state, options, 0, on_solution, found, max_solutions);
 	return solutions;
 }
 
+/**
+ * @brief Loads the board values into the search state.
+ * 
+ * @param board Board to load.
+ * @param state State to fill.
+ * @param options search settings.
+ * @return false if two given values collide or the propagation
+ * finds no solution.
+ */
+template <unsigned SW, unsigned SH>
+const bool Solver::load_state(const CompactBoard<SW, SH> &board, State<SW, SH> &state,
+		const SolverOptions &options) {
+	state.board = board;
+	state.eliminated.fill(0);
+	state.row_empty.fill(state.WIDTH);
+	state.col_empty.fill(state.WIDTH);
+	state.square_empty.fill(state.WIDTH);
+
+	for (unsigned i = 0; i < board.SIZE; i ++) {
+		auto v = board.get(i);
+		if (!v) continue;
+		if (!(candidates(state, i) & (1u << (v - 1)))) return false;
+		place(state, i, v);
+	}
+
+	return !options.propagation || propagate(state);
+}
+
+/**
+ * @brief Places the value v in the cell i and marks it as used.
+ */
+template <unsigned SW, unsigned SH>
+void Solver::place(State<SW, SH> &state, const unsigned i, const unsigned v) {
+	auto bit = 1u << (v - 1);
+	auto s = state.square(i);
+	state.board.set(i, v);
+	state.row_mask[i / state.WIDTH] |= bit;
+	state.col_mask[i % state.WIDTH] |= bit;
+	state.square_mask[s] |= bit;
+	state.row_empty[i / state.WIDTH] --;
+	state.col_empty[i % state.WIDTH] --;
+	state.square_empty[s] --;
+}
+
+/**
+ * @brief Clears the cell i and releases its value v.
+ */
+template <unsigned SW, unsigned SH>
+void Solver::unplace(State<SW, SH> &state, const unsigned i, const unsigned v) {
+	auto bit = ~(1u << (v - 1));
+	auto s = state.square(i);
+	state.board.set(i, 0);
+	state.row_mask[i / state.WIDTH] &= bit;
+	state.col_mask[i % state.WIDTH] &= bit;
+	state.square_mask[s] &= bit;
+	state.row_empty[i / state.WIDTH] ++;
+	state.col_empty[i % state.WIDTH] ++;
+	state.square_empty[s] ++;
+}
+
+/**
+ * @brief Returns the mask of the digits that fit in the cell i.
+ */
+template <unsigned SW, unsigned SH>
+const unsigned Solver::candidates(const State<SW, SH> &state, const unsigned i) {
+	return state.ALL & ~(state.row_mask[i / state.WIDTH] | state.col_mask[i % state.WIDTH] |
+			state.square_mask[state.square(i)] | state.eliminated[i]);
+}
+
+/**
+ * @brief Fills the forced cells until nothing changes.
+ * 
+ * @return false if a cell or a unit runs out of candidates.
+ */
+template <unsigned SW, unsigned SH>
+const bool Solver::propagate(State<SW, SH> &state) {
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		if (!place_singles(state, changed)) return false;
+
+		// The locked candidates are slower: only when the singles run out.
+		if (!changed) eliminate_locked(state, changed);
+		// The pairs cost more than they save up to 9x9: they pay off on
+		// the larger boards, where a wrong branch runs deep before failing.
+		if (!changed && state.WIDTH > 9) eliminate_pairs(state, changed);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Places the naked singles (cells with one candidate) and the
+ * hidden singles (digits with one cell left in a unit).
+ * 
+ * @param state Search state.
+ * @param changed set to true when a value is placed.
+ * @return false if a cell or a unit runs out of candidates.
+ */
+template <unsigned SW, unsigned SH>
+const bool Solver::place_singles(State<SW, SH> &state, bool &changed) {
+	for (unsigned i = 0; i < state.SIZE; i ++) {
+		if (state.board.get(i)) continue;
+
+		auto mask = candidates(state, i);
+		if (!mask) return false;
+		if (mask & (mask - 1)) continue;
+
+		place(state, i, unsigned(__builtin_ctz(mask)) + 1);
+		changed = true;
+	}
+
+	for (auto &unit : CompactBoard<SW, SH>::units()) {
+		// Digits seen in one cell of the unit and in more than one.
+		unsigned once = 0, twice = 0, used = 0;
+		for (auto i : unit) {
+			if (auto v = state.board.get(i)) {
+				used |= 1u << (v - 1);
+				continue;
+			}
+			auto mask = candidates(state, i);
+			twice |= once & mask;
+			once |= mask;
+		}
+		if ((once | used) != state.ALL) return false;
+
+		auto singles = once & ~twice;
+		while (singles) {
+			auto bit = singles & -singles;
+			singles ^= bit;
+
+			// Another single of the unit may have taken the cell.
+			auto cell = state.SIZE;
+			for (auto i : unit) {
+				if (state.board.get(i) || !(candidates(state, i) & bit)) continue;
+				cell = i;
+				break;
+			}
+			if (cell == state.SIZE) return false;
+
+			place(state, cell, unsigned(__builtin_ctz(bit)) + 1);
+			changed = true;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Removes the locked candidates: a digit confined to one line
+ * of a square is removed from the rest of the line (pointing), and
+ * a digit confined to one square of a line is removed from the rest
+ * of the square (claiming).
+ * 
+ * @param state Search state.
+ * @param changed set to true when a candidate is removed.
+ */
+template <unsigned SW, unsigned SH>
+void Solver::eliminate_locked(State<SW, SH> &state, bool &changed) {
+	constexpr auto WIDTH = State<SW, SH>::WIDTH;
+	auto &units = CompactBoard<SW, SH>::units();
+
+	// Removes bit from the cells of the unit u outside the unit except.
+	auto eliminate = [&](const unsigned u, const unsigned bit, auto except) {
+		for (auto i : units[u]) {
+			if (state.board.get(i) || except(i) || !(candidates(state, i) & bit)) continue;
+			state.eliminated[i] |= bit;
+			changed = true;
+		}
+	};
+
+	// Pointing: the rows and columns of each digit inside a square.
+	for (unsigned s = 0; s < WIDTH; s ++) {
+		std::array<unsigned, WIDTH> rows{}, cols{};
+		for (auto i : units[2 * WIDTH + s]) {
+			if (state.board.get(i)) continue;
+			for (auto mask = candidates(state, i); mask; mask &= mask - 1) {
+				auto d = __builtin_ctz(mask);
+				rows[d] |= 1u << (i / WIDTH);
+				cols[d] |= 1u << (i % WIDTH);
+			}
+		}
+
+		auto in_square = [s](const unsigned i) { return State<SW, SH>::square(i) == s; };
+		for (unsigned d = 0; d < WIDTH; d ++) {
+			if (rows[d] && !(rows[d] & (rows[d] - 1)))
+				eliminate(__builtin_ctz(rows[d]), 1u << d, in_square);
+			if (cols[d] && !(cols[d] & (cols[d] - 1)))
+				eliminate(WIDTH + __builtin_ctz(cols[d]), 1u << d, in_square);
+		}
+	}
+
+	// Claiming: the squares of each digit inside a row or column.
+	for (unsigned u = 0; u < 2 * WIDTH; u ++) {
+		std::array<unsigned, WIDTH> squares{};
+		for (auto i : units[u]) {
+			if (state.board.get(i)) continue;
+			for (auto mask = candidates(state, i); mask; mask &= mask - 1)
+				squares[__builtin_ctz(mask)] |= 1u << State<SW, SH>::square(i);
+		}
+
+		auto in_line = [u](const unsigned i) {
+			return u < WIDTH ? i / WIDTH == u : i % WIDTH == u - WIDTH;
+		};
+		for (unsigned d = 0; d < WIDTH; d ++) {
+			if (squares[d] && !(squares[d] & (squares[d] - 1)))
+				eliminate(2 * WIDTH + __builtin_ctz(squares[d]), 1u << d, in_line);
+		}
+	}
+}
+
+/**
+ * @brief Removes the candidates ruled out by the pairs of each unit:
+ * two cells with the same two candidates take them from the rest of
+ * the unit (naked pair), and two digits with the same two cells left
+ * take the other candidates from those cells (hidden pair).
+ * 
+ * @param state Search state.
+ * @param changed set to true when a candidate is removed.
+ */
+template <unsigned SW, unsigned SH>
+void Solver::eliminate_pairs(State<SW, SH> &state, bool &changed) {
+	constexpr auto WIDTH = State<SW, SH>::WIDTH;
+
+	for (auto &unit : CompactBoard<SW, SH>::units()) {
+		// Candidates of the unit cells, and the cells (by position in the unit) of each digit.
+		std::array<unsigned, WIDTH> masks{}, places{};
+		for (unsigned k = 0; k < WIDTH; k ++) {
+			if (state.board.get(unit[k])) continue;
+			masks[k] = candidates(state, unit[k]);
+			for (auto mask = masks[k]; mask; mask &= mask - 1)
+				places[__builtin_ctz(mask)] |= 1u << k;
+		}
+
+		// Naked pairs.
+		for (unsigned a = 0; a < WIDTH; a ++) {
+			if (__builtin_popcount(masks[a]) != 2) continue;
+			for (unsigned b = a + 1; b < WIDTH; b ++) {
+				if (masks[b] != masks[a]) continue;
+				for (unsigned k = 0; k < WIDTH; k ++) {
+					if (k == a || k == b || !(masks[k] & masks[a])) continue;
+					state.eliminated[unit[k]] |= masks[a];
+					masks[k] &= ~masks[a];
+					changed = true;
+				}
+			}
+		}
+
+		// Hidden pairs.
+		for (unsigned d = 0; d < WIDTH; d ++) {
+			if (__builtin_popcount(places[d]) != 2) continue;
+			for (unsigned e = d + 1; e < WIDTH; e ++) {
+				if (places[e] != places[d]) continue;
+				auto pair = (1u << d) | (1u << e);
+				for (auto cells = places[d]; cells; cells &= cells - 1) {
+					auto k = unsigned(__builtin_ctz(cells));
+					if (!(masks[k] & ~pair)) continue;
+					state.eliminated[unit[k]] |= state.ALL & ~pair;
+					masks[k] &= pair;
+					changed = true;
+				}
+			}
+		}
+	}
+}
+
 /**
  * @brief Internal solve() function for recursive calls.
  * 
- * @param board Board to solve.
- * @param solutions solutions found.
+ * @param state Search state.
+ * @param options search settings.
+ * @param start first cell that may be empty.
+ * @param on_solution called with the state of every solution found.
+ * @param found number of solutions found.
  * @param max_solutions maximum of solutions to find. -1 to all.
  * @return true if all solutions were found.
  */
-const bool Solver::solve(Board &board, std::list<Board> &solutions, const unsigned max_solutions) {
-	auto i = get_next_empty_cell(board);
+template <unsigned SW, unsigned SH, class OnSolution>
+const bool Solver::solve(State<SW, SH> &state, const SolverOptions &options,
+		const unsigned start, OnSolution &on_solution, unsigned &found,
+		const unsigned max_solutions) {
+	auto i = options.branching == SolverOptions::Branching::MRV ?
+			get_mrv_cell(state) : get_next_empty_cell(state, start);
 
-	if (i == board.get_size()) {
-		solutions.push_back(board);
+	if (i == state.board.SIZE) {
+		on_solution(state);
 
-		if (solutions.size() == max_solutions) return true;
-		return false;
+		found ++;
+		return found == max_solutions;
 	}
 
-	auto s = board.get_width();
+	// Try the candidates from the lowest digit, one bit at a time.
+	auto mask = candidates(state, i);
+	while (mask) {
+		auto bit = mask & -mask;
+		mask ^= bit;
+
+		auto v = unsigned(__builtin_ctz(bit)) + 1;
 
-	for (unsigned v = 1; v <= s; v ++) {
-		board.board[i].value = v;
-		if (board.is_valid(i % s, std::floor(i / s))) {
-			if (solve(board, solutions, max_solutions)) return true;
+		// Propagation changes more than one cell: branch on a copy.
+		if (options.propagation) {
+			auto next = state;
+			place(next, i, v);
+			if (propagate(next) &&
+					solve(next, options, i + 1, on_solution, found, max_solutions)) return true;
+			continue;
 		}
-		board.board[i].value = 0;
 
+		place(state, i, v);
+		if (solve(state, options, i + 1, on_solution, found, max_solutions)) return true;
+		unplace(state, i, v);
 	}
 
 	return false;
@@ -59,13 +471,60 @@ const bool Solver::solve(Board &board, std::list<Board> &solutions, const unsign
 
 /**
  * @brief Returns the next position with value = 0 on the board
- * starting from the top left.
+ * starting from the given cell.
  */
-const unsigned Solver::get_next_empty_cell(const Board &board) {
-	for (unsigned i = 0; i < board.get_size(); i ++) {
-		if (board.board[i].value) continue;
+template <unsigned SW, unsigned SH>
+const unsigned Solver::get_next_empty_cell(const State<SW, SH> &state, const unsigned start) {
+	for (unsigned i = start; i < state.board.SIZE; i ++) {
+		if (state.board.get(i)) continue;
 		return i;
 	}
 
-	return board.get_size();
+	return state.board.SIZE;
+}
+
+/**
+ * @brief Returns the empty cell with the fewest candidates. Ties are
+ * broken by the number of empty cells sharing its row, column and square.
+ * Returns the board size when the board is full.
+ */
+template <unsigned SW, unsigned SH>
+const unsigned Solver::get_mrv_cell(const State<SW, SH> &state) {
+	unsigned best = state.board.SIZE;
+	unsigned best_count = state.WIDTH + 1, best_degree = 0;
+
+	for (unsigned i = 0; i < state.board.SIZE; i ++) {
+		if (state.board.get(i)) continue;
+
+		auto count = unsigned(__builtin_popcount(candidates(state, i)));
+		if (count > best_count) continue;
+
+		auto degree = state.row_empty[i / state.WIDTH] + state.col_empty[i % state.WIDTH] +
+				state.square_empty[state.square(i)];
+		if (count == best_count && degree <= best_degree) continue;
+
+		best = i; best_count = count; best_degree = degree;
+
+		// A dead end or a forced value: nothing can beat it.
+		if (count <= 1) break;
+	}
+
+	return best;
 }
+
+// Board geometries supported by the compact representation.
+template const unsigned Solver::count_solutions(const CompactBoard<2, 2> &,
+		const unsigned, const SolverOptions &);
+template const unsigned Solver::count_solutions(const CompactBoard<3, 2> &,
+		const unsigned, const SolverOptions &);
+template const unsigned Solver::count_solutions(const CompactBoard<3, 3> &,
+		const unsigned, const SolverOptions &);
+template const unsigned Solver::count_solutions(const CompactBoard<4, 4> &,
+		const unsigned, const SolverOptions &);
+template const unsigned Solver::count_solutions(const CompactBoard<5, 5> &,
+		const unsigned, const SolverOptions &);
+template const bool Solver::solve_first(CompactBoard<2, 2> &, const SolverOptions &);
+template const bool Solver::solve_first(CompactBoard<3, 2> &, const SolverOptions &);
+template const bool Solver::solve_first(CompactBoard<3, 3> &, const SolverOptions &);
+template const bool Solver::solve_first(CompactBoard<4, 4> &, const SolverOptions &);
+template const bool Solver::solve_first(CompactBoard<5, 5> &, const SolverOptions &);
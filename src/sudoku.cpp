@@ -34,6 +34,8 @@
  */
 SudokuApp::SudokuApp(int argc, char *argv[]) :
 		Gtk::Application(argc, argv, "com.codigoymate.sudoku") {
+	generated_dispatcher.connect([this]() { this->on_board_generated(); });
+	solved_dispatcher.connect([this]() { this->on_board_solved(); });
 }
 
 /**
@@ -66,6 +68,10 @@ void SudokuApp::on_activate() {
 	if (!Config::load()) Config::save();
 	Config::load();
 
+	generator_pool = std::make_unique<GeneratorPool>(Config::get_generator_workers());
+	puzzle_pool = std::make_unique<PuzzlePool>(Config::get_config_path(),
+			Config::get_pool_watermark());
+
 	// Sets the player
 	player.set_name(Config::get_current_player());
 	player.load_config(this);
@@ -82,39 +88,105 @@ void SudokuApp::on_activate() {
  */
 void SudokuApp::new_game(const unsigned size, const unsigned difficulty) {
 
-	switch (difficulty) {
-	// Easy
-	case 0:
-		if (size == 81)
-			board = Generator::generate_board(Generator::rand_int(35, 45), 1, 81);
-		else board = Generator::generate_board(Generator::rand_int(10, 11), 1, 16);
-		board.set_difficulty("Easy");
-		break;
-	// Medium
-	case 1:
-		if (size == 81)
-			board = Generator::generate_board(Generator::rand_int(30, 34), 1, 81);
-		else board = Generator::generate_board(Generator::rand_int(8, 9), 1, 16);
-		board.set_difficulty("Medium");
-		break;
-	// Hard
-	case 2:
-		if (size == 81)
-			board = Generator::generate_board(Generator::rand_int(26, 29), 1, 81);
-		else board = Generator::generate_board(Generator::rand_int(5, 7), 1, 16);
-		board.set_difficulty("Hard");
-		break;
+	// Cancel a pending request: its racers stop searching
+	generator_pool->cancel();
+	generating = std::future<GeneratedBoard>();
+	solving = std::future<Board>();
+
+	if (puzzle_pool->pop(size, difficulty, board, solved)) {
+		start_game();
+		return;
+	}
+
+	// Empty board until the generated one is ready
+	board = Board(size);
+	solved = Board(size);
+
+	generating = generator_pool->generate(size, difficulty, [this]() {
+		generated_dispatcher.emit();
+	});
+
+	main_window->update();
+}
+
+/**
+ * @brief Starts the game with the generated board, on the main loop.
+ * 
+ */
+void SudokuApp::on_board_generated() {
+	// Result of a replaced request: wait for the current one.
+	if (!generating.valid() ||
+			generating.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+
+	// The generator keeps the full board it removed the numbers from.
+	auto generated = generating.get();
+	board = generated.board;
+	if (board.empty()) {
+		main_window->update();
+		return;
 	}
+	solved = generated.solved;
 
-	auto sol = Solver::solve(board, 100);
-	solved = sol.front();
+	start_game();
+}
 
+/**
+ * @brief Keeps the solution of the loaded board, on the main loop.
+ * 
+ */
+void SudokuApp::on_board_solved() {
+	// Result of a replaced request: wait for the current one.
+	if (!solving.valid() ||
+			solving.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+
+	auto solution = solving.get();
+	if (!solution.full()) {
+		std::cerr << "Error: board " << board.get_id() << " has no solution." << std::endl;
+		return;
+	}
+	solved = solution;
+}
+
+/**
+ * @brief Saves and shows the new board.
+ * 
+ */
+void SudokuApp::start_game() {
+	journal.start(journal_path(board.get_id()), board, save_queue);
 	this->save_board();
 	player.save_config(this);
 
 	main_window->update();
 }
 
+/**
+ * @brief Get the collection index of the current player.
+ * 
+ * @return CollectionIndex& collection index.
+ */
+CollectionIndex &SudokuApp::get_collection() {
+	auto &index = *get_collection_index();
+	index.load();
+	return index;
+}
+
+/**
+ * @brief Get the collection index of the current player, maybe not
+ * loaded yet: CollectionIndex::load() can then run on a worker.
+ * 
+ * @return std::shared_ptr<CollectionIndex> collection index.
+ */
+std::shared_ptr<CollectionIndex> SudokuApp::get_collection_index() {
+	auto path = Config::get_config_path() + player.get_name() + "/";
+	if (!collection || collection->get_path() != path) {
+		journal.close();
+		collection = std::make_shared<CollectionIndex>(path);
+	}
+	return collection;
+}
+
 /**
  * @brief Save the current board to the player path.
  * 
@@ -122,9 +194,121 @@ void SudokuApp::new_game(const unsigned size, const unsigned difficulty) {
 void SudokuApp::save_board() {
 	if (board.empty()) return ;
 
-	auto path = Config::get_config_path() + player.get_name() + "/collection/";
+	save_snapshot();
+
+	// The snapshot holds the moves and the notes: the journal starts
+	// from it, so its replay prunes the notes of the later moves only.
+	if (journal.get_path() == journal_path(board.get_id())) journal.compact();
+}
+
+/**
+ * @brief Returns the journal file of a board.
+ */
+const std::string SudokuApp::journal_path(const std::string id) {
+	auto path = get_collection().get_path() + "journal/";
 	Utils::create_directory_if_not_exists(path);
-	board.save(path + board.get_id() + ".xml");
+	return path + id + ".log";
+}
+
+/**
+ * @brief Sets a value of the current board and records the move
+ * in the board journal.
+ */
+void SudokuApp::play(const unsigned x, const unsigned y, const unsigned value) {
+	journal.play(board, x, y, value);
+
+	if (journal.get_records() >= MoveJournal::COMPACT_RECORDS) save_board();
+}
+
+/**
+ * @brief Adds or removes a pencil mark of an empty cell.
+ */
+void SudokuApp::toggle_note(const unsigned x, const unsigned y, const unsigned value) {
+	if (board.get(x, y).value || !value || value > board.get_width()) return;
+
+	board.set_notes(x, y, board.get_notes(x, y) ^ (1u << (value - 1)));
+	save_board();
+}
+
+/**
+ * @brief Replaces the pencil marks with the candidates of every
+ * empty cell.
+ */
+void SudokuApp::fill_notes() {
+	if (board.empty()) return;
+
+	auto masks = Solver::candidate_masks(board);
+	auto w = board.get_width();
+	for (unsigned i = 0; i < masks.size(); i ++) board.set_notes(i % w, i / w, masks[i]);
+
+	save_board();
+}
+
+/**
+ * @brief Reverts the last move of the current board.
+ * 
+ * @param x, y set to the cell of the move.
+ * @return false if there is no move to undo.
+ */
+const bool SudokuApp::undo(unsigned &x, unsigned &y) {
+	return journal.undo(board, x, y);
+}
+
+/**
+ * @brief Plays again the last undone move of the current board.
+ * 
+ * @param x, y set to the cell of the move.
+ * @return false if there is no move to redo.
+ */
+const bool SudokuApp::redo(unsigned &x, unsigned &y) {
+	return journal.redo(board, x, y);
+}
+
+/**
+ * @brief Clears the values of the current board and its history.
+ * 
+ */
+void SudokuApp::reset_board() {
+	board.reset();
+	journal.start(journal_path(board.get_id()), board, save_queue);
+	save_board();
+}
+
+/**
+ * @brief Queues the write of the current board and its index entry.
+ * 
+ */
+void SudokuApp::save_snapshot() {
+	auto &collection = get_collection();
+	Utils::create_directory_if_not_exists(collection.get_collection_path());
+
+	// Serialized on the save queue, from a copy of the board.
+	auto file = collection.get_board_file(board.get_id());
+	auto binary = collection.get_collection_path() + board.get_id() + ".board";
+	save_queue.save(binary, [board = this->board]() {
+		return board.serialize(Board::Format::BINARY);
+	});
+
+	// Boards of older versions are moved to the binary format.
+	if (file != binary) {
+		save_queue.flush();
+		Utils::remove_file(file);
+	}
+
+	collection.update(board);
+	save_collection();
+}
+
+/**
+ * @brief Queues the write of the collection index.
+ * 
+ */
+void SudokuApp::save_collection() {
+	// Written after the board files: a board written later would make
+	// the collection directory newer and the index stale.
+	save_queue.save(collection->get_index_path(), [collection = this->collection]() {
+		return collection->serialize();
+	}, true);
 }
 
 /**
@@ -136,13 +320,24 @@ void SudokuApp::load_board() {
 	// If no current board id.. no load. 
 	if (board.get_id() == "") return;
 
-	auto path = Config::get_config_path() + player.get_name() + "/collection/";
-	board.load(path + board.get_id() + ".xml");
+	// The board file may be waiting on the save queue.
+	save_queue.flush();
+	if (!board.load(get_collection().get_board_file(board.get_id()))) {
+		journal.close();
+		board = Board();
+		solved = Board();
+		solving = std::future<Board>();
+		return;
+	}
+
+	// The journal holds the moves played after the last snapshot.
+	if (!journal.open(journal_path(board.get_id()), board, save_queue))
+		journal.start(journal_path(board.get_id()), board, save_queue);
 	
-	auto solving = board;
-	solving.reset();
-	auto sol = Solver::solve(solving, 100);
-	solved = sol.front();
+	// Large boards can take seconds to solve: the solution is found on
+	// a worker, the board is played meanwhile.
+	solved = Board(board.get_size());
+	solving = generator_pool->solve(board, [this]() { solved_dispatcher.emit(); });
 }
 
 /**
@@ -153,17 +348,22 @@ void SudokuApp::load_board() {
 void SudokuApp::remove_board(const Board &board) {
 	// If the removing board is the current. Close it.
 	if (board.get_id() == this->board.get_id()) {
+		journal.close();
 		this->board = Board();
 		this->solved = Board();
+		solving = std::future<Board>();
 		main_window->update();
 
 		player.save_config(this);
 	}
 
-	auto path = Config::get_config_path() + player.get_name() + "/collection/";
-	path += board.get_id() + ".xml";
+	// A pending save would write the file again.
+	save_queue.flush();
+	Utils::remove_file(get_collection().get_board_file(board.get_id()));
+	Utils::remove_file(journal_path(board.get_id()));
 
-	Utils::remove_file(path);
+	get_collection().remove(board.get_id());
+	save_collection();
 }
 
 /**
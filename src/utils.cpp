@@ -9,6 +9,8 @@
  */
 #include <utils.h>
 
+#include <grid-cache.h>
+
 #include <sys/stat.h>
 #include <dirent.h>
 #include <cstring>
@@ -191,27 +193,53 @@ void Utils::remove_directory(const std::string path) {
 
 /**
  * @brief Draw Sudoku grid on cairo context.
+ * The grid lines and the digits are copied from the GridCache
+ * of the board geometry and size.
  * 
  * @param cr Cairo context.
  * @param w width of the widget.
  * @param h height of the widget.
+ * @param highlight cells tinted by a hint, by index (empty for none,
+ * ignored when it does not match the board size).
  */
 void Utils::draw_grid(const Cairo::RefPtr<Cairo::Context>& cr, const Board &board,
 		const unsigned w, const unsigned h,
 		const int sel_x, const int sel_y,
-		const bool error) {
+		const bool error, const std::vector<bool> &highlight) {
 
 	double s_size = double(w <= h ? w : h) / double(board.get_width());
 
 	auto s = board.get_width();
+	auto &cache = GridCache::get(cr, board, s_size);
+
+	// Only the cells inside the clip region (the queued areas) are drawn.
+	double clip_x1, clip_y1, clip_x2, clip_y2;
+	cr->get_clip_extents(clip_x1, clip_y1, clip_x2, clip_y2);
+
+	auto visible = [&](const unsigned x, const unsigned y) {
+		return (x + 1) * s_size >= clip_x1 && x * s_size <= clip_x2 &&
+				(y + 1) * s_size >= clip_y1 && y * s_size <= clip_y2;
+	};
 
 	for (unsigned y = 0; y < s; y ++) {
 		for (unsigned x = 0; x < s; x ++) {
+			if (!visible(x, y)) continue;
 
 			// Draw Rectangle
 			if (board.get(x, y).fixed) cr->set_source_rgb(0.8, 0.8, 0.8);
 			else cr->set_source_rgb(1, 1, 1);
 
+			// Repeated values
+			if (!board.is_valid(x, y)) {
+				if (board.get(x, y).fixed) cr->set_source_rgb(0.85, 0.65, 0.65);
+				else cr->set_source_rgb(1.0, 0.8, 0.8);
+			}
+
+			if (highlight.size() == board.get_size() && highlight[y * s + x]) {
+				if (board.get(x, y).fixed) cr->set_source_rgb(0.85, 0.85, 0.6);
+				else cr->set_source_rgb(1.0, 1.0, 0.7);
+			}
+
 			if (x == sel_x && y == sel_y) {
 				if (!board.get(x, y).fixed) {
 					if (error) {
@@ -224,46 +252,22 @@ void Utils::draw_grid(const Cairo::RefPtr<Cairo::Context>& cr, const Board &boar
 			
 			cr->rectangle(x * s_size, y * s_size, s_size, s_size);
 			cr->fill();
-
-			cr->set_source_rgb(0, 0, 0);
-			cr->set_line_width(s_size * 0.02);
-			cr->rectangle(x * s_size, y * s_size, s_size, s_size);
-
-			cr->stroke();
-
-			// Draw number
-			if (board.get(x, y).value) {
-				cr->select_font_face("sans", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_BOLD);
-				cr->set_font_size(s_size * 0.7);
-				cr->move_to(x * s_size + s_size * 0.25, y * s_size + s_size * 0.8);
-				cr->show_text(std::to_string(board.get(x, y).value));
-			}
 		}
 	}
 
-	// Draw Separators
-	cr->set_source_rgb(0, 0, 0);
-	cr->set_line_width(s_size * 0.09);
+	// Draw borders and separators
+	cache.paint_lines(cr);
 
-	if (board.get_size() == 81) {
-		cr->move_to(s_size * 3, 0);
-		cr->line_to(s_size * 3, s_size * 9);
-		cr->move_to(s_size * 6, 0);
-		cr->line_to(s_size * 6, s_size * 9);
-
-		cr->move_to(0, s_size * 3);
-		cr->line_to(s_size * 9, s_size * 3);
-		cr->move_to(0, s_size * 6);
-		cr->line_to(s_size * 9, s_size * 6);
-	} else {
-		cr->move_to(s_size * 2, 0);
-		cr->line_to(s_size * 2, s_size * 4);
-		cr->move_to(0, s_size * 2);
-		cr->line_to(s_size * 4, s_size * 2);
+	// Draw numbers
+	for (unsigned y = 0; y < s; y ++) {
+		for (unsigned x = 0; x < s; x ++) {
+			auto cell = board.get(x, y);
+			if (!visible(x, y)) continue;
+			if (cell.value) cache.paint_digit(cr, x, y, cell.value, cell.fixed);
+			else if (auto notes = board.get_notes(x, y)) cache.paint_notes(cr, x, y, notes);
+		}
 	}
 
-	cr->stroke();
-
 }
 
 /**
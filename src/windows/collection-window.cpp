@@ -18,16 +18,19 @@
 #include <config.h>
 #include <utils.h>
 
-#include <board-view.h>
+#include <collection-view.h>
+
+#include <algorithm>
+#include <unordered_map>
 
 /**
  * @brief Construct a new CollectionWindow
  */
 CollectionWindow::CollectionWindow(BaseObjectType* obj, Glib::RefPtr<Gtk::Builder> const& builder,
 			SudokuApp *app, WelcomeWindow *ww) : Gtk::Window(obj), app{app}, welcomeWindow{ww} {
-	builder->get_widget("board-flow", board_flow);
-	board_flow->signal_selected_children_changed().connect([this]() {
-		this->board_flow_selection_changed();
+	builder->get_widget_derived("collection-area", collection_view);
+	collection_view->signal_selection_changed().connect([this]() {
+		this->board_selection_changed();
 	});
 
 	builder->get_widget("play-button", play_button);
@@ -40,11 +43,28 @@ CollectionWindow::CollectionWindow(BaseObjectType* obj, Glib::RefPtr<Gtk::Builde
 		this->remove_button_clicked();
 	});
 
+	builder->get_widget("sort-combo", sort_combo);
+	sort_combo->signal_changed().connect([this]() {
+		this->sort_changed();
+	});
+
+	loaded_dispatcher.connect([this]() { this->on_boards_loaded(); });
+
+	// Closing the window cancels the boards not loaded yet.
+	signal_hide().connect([this]() { this->stop_loading(); });
+
 	load_boards();
 
 	update();
 }
 
+/**
+ * @brief Cancel the board loading.
+ */
+CollectionWindow::~CollectionWindow() {
+	stop_loading();
+}
+
 /**
  * @brief Show this window.
  * 
@@ -64,88 +84,139 @@ void CollectionWindow::show(SudokuApp *app, WelcomeWindow *ww) {
 }
 
 /**
- * @brief Load board list from collection and fills list flow.
+ * @brief Load board list from collection and fills the view.
+ * A worker thread loads the collection index (rebuilt when stale),
+ * then builds the boards, added to the view in batches.
  * 
  */
 void CollectionWindow::load_boards() {
+	stop_loading();
 	board_list.clear();
-	for (auto *child : board_flow->get_children()) board_flow->remove(*child);
-
-	auto file_list = Utils::get_file_list(Config::get_config_path() + 
-						Config::get_current_player() + "/collection");
-	for (auto file : file_list) {
-		Board board;
-		board.load(Config::get_config_path() + Config::get_current_player() + 
-				"/collection/" + file);
-		board_list.push_back(board);
+	entries.clear();
+
+	collection_view->set_items(board_list);
+
+	cancel_loading = false;
+	loader = std::thread([this, collection = app->get_collection_index(), key = get_sort_key()]() {
+		this->run_loader(collection, key);
+	});
+}
+
+/**
+ * @brief Worker thread: loads the index and builds the boards in
+ * the list order.
+ * 
+ * @param collection collection index, maybe not loaded yet.
+ * @param key sort order of the list.
+ */
+void CollectionWindow::run_loader(std::shared_ptr<CollectionIndex> collection, const CollectionSort key) {
+	collection->load();
+	auto entries = collection->get_entries();
+	if (cancel_loading) return;
+
+	{
+		std::lock_guard<std::mutex> lock(loaded_mutex);
+		listed = entries;
 	}
+	loaded_dispatcher.emit();
 
-	this->sort_boards();
+	// Boards in the list order, so the first tiles are filled first.
+	auto order = CollectionIndex::sort(entries, key);
+	std::vector<Board> batch;
+
+	for (unsigned i = 0; i < order.size(); i ++) {
+		if (cancel_loading) return;
+
+		batch.push_back(entries[order[i]].to_board());
+		if (batch.size() < LOAD_BATCH && i + 1 < order.size()) continue;
 
-	for (auto &board : board_list) {
-		auto vbox = Gtk::make_managed<Gtk::Box>();
-		vbox->set_orientation(Gtk::Orientation::ORIENTATION_VERTICAL);
-		board_flow->add(*vbox);
-
-		// Board view
-		auto board_view = Gtk::make_managed<BoardView>(board);
-		board_view->set_size_request(150, 150);
-		board_view->set_halign(Gtk::Align::ALIGN_CENTER);
-		vbox->add(*board_view);
-
-		// Board name
-		auto name_label = Gtk::make_managed<Gtk::Label>(board.get_name());
-		name_label->get_style_context()->add_class("board-name");
-		vbox->add(*name_label);
-
-		auto hbox = Gtk::make_managed<Gtk::Box>();
-		hbox->set_orientation(Gtk::Orientation::ORIENTATION_HORIZONTAL);
-		hbox->set_halign(Gtk::Align::ALIGN_CENTER);
-		hbox->set_spacing(7);
-		vbox->add(*hbox);
-
-		// Difficulty
-		hbox->add(*Gtk::make_managed<Gtk::Label>(board.get_difficulty()));
-
-		// Solved
-		if (board.is_solved_mark()) {
-
-			// Add a separator
-			hbox->add(*Gtk::make_managed<Gtk::Separator>());
-
-			// Solved label
-			auto solved = Gtk::make_managed<Gtk::Label>("Solved");
-			solved->get_style_context()->add_class("solved-board-name");
-			hbox->add(*solved);
+		{
+			std::lock_guard<std::mutex> lock(loaded_mutex);
+			loaded.insert(loaded.end(), batch.begin(), batch.end());
 		}
+		batch.clear();
+		loaded_dispatcher.emit();
+	}
+}
+
+/**
+ * @brief Fills the list with the entries and adds the loaded boards
+ * to the view, on the main loop.
+ * 
+ */
+void CollectionWindow::on_boards_loaded() {
+	std::vector<CollectionEntry> list;
+	std::vector<Board> boards;
+	{
+		std::lock_guard<std::mutex> lock(loaded_mutex);
+		list.swap(listed);
+		boards.swap(loaded);
 	}
 
-	board_flow->show_all();
+	if (!list.empty()) {
+		entries = list;
+		this->sort_boards();
+		collection_view->set_items(board_list);
+	}
+
+	if (!boards.empty()) collection_view->add_boards(boards);
 }
 
 /**
- * @brief Sort the board list from most recent to old.
+ * @brief Stops and joins the loading worker.
+ * 
+ */
+void CollectionWindow::stop_loading() {
+	cancel_loading = true;
+	if (loader.joinable()) loader.join();
+
+	std::lock_guard<std::mutex> lock(loaded_mutex);
+	listed.clear();
+	loaded.clear();
+}
+
+/**
+ * @brief Returns the key selected in the sort combo.
+ */
+const CollectionSort CollectionWindow::get_sort_key() const {
+	static const std::unordered_map<std::string, CollectionSort> keys = {
+		{"id", CollectionSort::ID},
+		{"difficulty", CollectionSort::DIFFICULTY},
+		{"solved", CollectionSort::SOLVED},
+		{"played", CollectionSort::PLAYED}
+	};
+
+	auto key = keys.find(sort_combo->get_active_id());
+	return key != keys.end() ? key->second : CollectionSort::ID;
+}
+
+/**
+ * @brief Sort the board list by the key selected in the sort combo.
  * 
  */
 void CollectionWindow::sort_boards() {
+	auto order = CollectionIndex::sort(entries, get_sort_key());
 
-	if (!board_list.size()) return ;
+	board_list.clear();
+	board_list.reserve(order.size());
+	for (auto i : order) board_list.push_back(entries[i].id);
+}
 
-	for (signed i = 0; i < board_list.size() - 1; i ++) {
-		if (board_list[i].get_id() > board_list[i + 1].get_id()) {
-			auto tmp = board_list[i];
-			board_list[i] = board_list[i + 1];
-			board_list[i + 1] = tmp;
-			i = -1;
-		}
-	}
+/**
+ * @brief Sort combo changed event.
+ * 
+ */
+void CollectionWindow::sort_changed() {
+	// Sorting only moves the tiles: the loaded boards are kept.
+	this->sort_boards();
+	collection_view->reorder_items(board_list);
 }
 
 /**
  * @brief Selection change event
  * 
  */
-void CollectionWindow::board_flow_selection_changed() {
+void CollectionWindow::board_selection_changed() {
 	update();
 }
 
@@ -155,18 +226,13 @@ void CollectionWindow::board_flow_selection_changed() {
  */
 void CollectionWindow::play_button_clicked() {
 
-	unsigned index = 0;
-
-	for (auto item : board_flow->get_children()) {
-		if (item == board_flow->get_selected_children().front()) {
-			break;
-		} index ++;
-	}
+	auto id = collection_view->get_selected();
+	if (id.empty()) return;
 
 	welcomeWindow->set_quit_app(false);
 	this->close();
 	welcomeWindow->close();
-	app->get_board().set_id(board_list[index].get_id());
+	app->get_board().set_id(id);
 	app->get_player().save_config(app);
 	app->load_board();
 	app->get_main_window()->update();
@@ -177,13 +243,8 @@ void CollectionWindow::play_button_clicked() {
  * 
  */
 void CollectionWindow::remove_button_clicked() {
-	unsigned index = 0;
-
-	for (auto item : board_flow->get_children()) {
-		if (item == board_flow->get_selected_children().front()) {
-			break;
-		} index ++;
-	}
+	auto id = collection_view->get_selected();
+	if (id.empty()) return;
 
 	Gtk::MessageDialog dialog(*app->get_main_window(), "Remove game?", false, Gtk::MESSAGE_QUESTION, Gtk::BUTTONS_YES_NO);
 	dialog.set_secondary_text("Remove the game permanently from the collection.");
@@ -191,9 +252,15 @@ void CollectionWindow::remove_button_clicked() {
 	int result = dialog.run();
 	if (result == Gtk::RESPONSE_NO) return;
 
-	app->remove_board(board_list[index]);
+	Board board;
+	board.set_id(id);
+	app->remove_board(board);
 
-	load_boards();
+	// Only the removed tile goes away: the other boards stay loaded.
+	board_list.erase(std::remove(board_list.begin(), board_list.end(), id), board_list.end());
+	entries.erase(std::remove_if(entries.begin(), entries.end(),
+			[&id](const CollectionEntry &e) { return e.id == id; }), entries.end());
+	collection_view->remove_item(id);
 	update();
 
 	welcomeWindow->update();
@@ -204,7 +271,7 @@ void CollectionWindow::remove_button_clicked() {
  * 
  */
 void CollectionWindow::update() {
-	if (board_flow->get_selected_children().size() == 0) {
+	if (collection_view->get_selected().empty()) {
 		play_button->set_sensitive(false);
 		remove_button->set_sensitive(false);
 	} else {
@@ -49,8 +49,12 @@ bool MainWindow::on_window_delete(GdkEventAny* event) {
  * 
  */
 void MainWindow::update() {
-	board_name_label->set_text("Game: " + app->get_board().get_name());
+	if (app->is_generating()) board_name_label->set_text("Game: generating ...");
+	else board_name_label->set_text("Game: " + app->get_board().get_name());
 	level_label->set_text("Level: " + app->get_board().get_difficulty());
+	// The hint cells and a typed digit belong to the previous board.
+	board_area->clear_hint();
+	board_area->clear_pending_digit();
 	board_area->queue_draw();
 
 	// Update number buttons
@@ -61,7 +65,7 @@ void MainWindow::update() {
 
 		button->signal_clicked().connect([this, button]() {
 			app->get_main_window()->get_board_area()->chosen_a_number(
-				button->get_label().c_str()[0] - '0'
+				std::stoi(button->get_label())
 			);
 		});
 
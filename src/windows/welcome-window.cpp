@@ -168,9 +168,8 @@ void WelcomeWindow::exit_button_clicked() {
 void WelcomeWindow::update() {
 	welcome_label->set_text("Welcome, " + app->get_player().get_name());
 
-	auto board_path = Config::get_config_path() +
-		app->get_player().get_name() + "/collection/" +
-		app->get_board().get_id() + ".xml";
-
-	continue_button->set_sensitive(Utils::file_exists(board_path));
+	// The board file, not the index: the index is loaded off the main loop.
+	auto id = app->get_board().get_id();
+	continue_button->set_sensitive(!id.empty() &&
+			Utils::file_exists(app->get_collection_index()->get_board_file(id)));
 }